@@ -77,7 +77,10 @@ int* Base64Converter::InitBase64Table(const string& alphabet)
 	// Casts to avoid compiler warnings.
 	base64_table[int(alphabet[62])] = 62;
 	base64_table[int(alphabet[63])] = 63;
-	base64_table[int('=')] = 0;
+
+	// Padding is dealt with separately by Decode(), so that a table
+	// lookup alone tells whether a character is part of the alphabet.
+	base64_table[int('=')] = -1;
 
 	return base64_table;
 	}
@@ -133,9 +136,41 @@ int Base64Converter::Decode(int len, const char* data, int* pblen, char** pbuf)
 		}
 
 	int dlen = 0;
+	char* buf_end = *pbuf + blen;
 
 	while ( 1 )
 		{
+		if ( base64_group_next == 0 && ! base64_after_padding )
+			{
+			// Decode complete groups straight into the buffer for
+			// as long as they consist of alphabet characters only.
+			// Anything else, including padding, takes the
+			// character-wise path below.
+			const unsigned char* p = (const unsigned char*) data + dlen;
+			const unsigned char* p_end = (const unsigned char*) data + len;
+
+			while ( p_end - p >= 4 && buf_end - buf >= 3 )
+				{
+				int a = base64_table[p[0]];
+				int b = base64_table[p[1]];
+				int c = base64_table[p[2]];
+				int d = base64_table[p[3]];
+
+				if ( (a | b | c | d) < 0 )
+					break;
+
+				uint32_t bit32 = (a << 18) | (b << 12) | (c << 6) | d;
+				buf[0] = char((bit32 >> 16) & 0xff);
+				buf[1] = char((bit32 >> 8) & 0xff);
+				buf[2] = char((bit32) & 0xff);
+
+				buf += 3;
+				p += 4;
+				}
+
+			dlen = p - (const unsigned char*) data;
+			}
+
 		if ( base64_group_next == 4 )
 			{
 			// For every group of 4 6-bit numbers,
@@ -150,7 +185,7 @@ int Base64Converter::Decode(int len, const char* data, int* pblen, char** pbuf)
 
 			int num_octets = 3 - base64_padding;
 
-			if ( buf + num_octets > *pbuf + blen )
+			if ( buf + num_octets > buf_end )
 				break;
 
 			uint32_t bit32 =
@@ -178,10 +213,16 @@ int Base64Converter::Decode(int len, const char* data, int* pblen, char** pbuf)
 		if ( dlen >= len )
 			break;
 
+		int k;
+
 		if ( data[dlen] == '=' )
+			{
 			++base64_padding;
+			k = 0;
+			}
+		else
+			k = base64_table[(unsigned char) data[dlen]];
 
-		int k = base64_table[(unsigned char) data[dlen]];
 		if ( k >= 0 )
 			base64_group[base64_group_next++] = k;
 		else
@@ -36,6 +36,9 @@ public:
 	int Done(int* pblen, char** pbuf);
 	int HasData() const { return base64_group_next != 0; }
 
+	// True if a complete group is waiting for output space.
+	int HasPendingGroup() const { return base64_group_next == 4; }
+
 	// True if an error has occurred.
 	int Errored() const	{ return errored; }
 
@@ -8,8 +8,10 @@
 #include <algorithm>
 
 #include "BroString.h"
+#include "Hash.h"
 #include "Var.h"
 #include "Reporter.h"
+#include "3rdparty/doctest.h"
 
 #ifdef DEBUG
 #define DEBUG_STR(msg) DBG_LOG(DBG_STRING, msg)
@@ -31,6 +33,7 @@ BroString::BroString(int arg_final_NUL, byte_vec str, int arg_n)
 	n = arg_n;
 	final_NUL = arg_final_NUL;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	}
 
 BroString::BroString(const u_char* str, int arg_n, int add_NUL)
@@ -38,6 +41,7 @@ BroString::BroString(const u_char* str, int arg_n, int add_NUL)
 	b = 0;
 	n = 0;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	Set(str, arg_n, add_NUL);
 	}
 
@@ -46,6 +50,7 @@ BroString::BroString(const char* str)
 	b = 0;
 	n = 0;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	Set(str);
 	}
 
@@ -54,6 +59,7 @@ BroString::BroString(const string &str)
 	b = 0;
 	n = 0;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	Set(str);
 	}
 
@@ -62,6 +68,7 @@ BroString::BroString(const BroString& bs)
 	b = 0;
 	n = 0;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	*this = bs;
 	}
 
@@ -71,6 +78,7 @@ BroString::BroString()
 	n = 0;
 	final_NUL = 0;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	}
 
 void BroString::Reset()
@@ -84,6 +92,7 @@ void BroString::Reset()
 	n = 0;
 	final_NUL = 0;
 	use_free_to_delete = 0;
+	hash_cached = 0;
 	}
 
 const BroString& BroString::operator=(const BroString &bs)
@@ -110,6 +119,46 @@ bool BroString::operator<(const BroString &bs) const
 	return Bstr_cmp(this, &bs) < 0;
 	}
 
+uint64_t BroString::Hash() const
+	{
+	if ( ! hash_cached )
+		{
+		hash = HashKey::HashBytes(b, n);
+		hash_cached = 1;
+		}
+
+	return hash;
+	}
+
+TEST_CASE("BroString hash follows changes to the contents")
+	{
+	BroString s("abc");
+	CHECK_EQ(s.Hash(), HashKey::HashBytes("abc", 3));
+
+	// The second call returns the cached value.
+	CHECK_EQ(s.Hash(), HashKey::HashBytes("abc", 3));
+
+	s.ToUpper();
+	CHECK_EQ(s.Hash(), HashKey::HashBytes("ABC", 3));
+
+	s.Set("xyzw");
+	CHECK_EQ(s.Hash(), HashKey::HashBytes("xyzw", 4));
+
+	BroString t("other");
+	t.Hash();
+	t = s;
+	CHECK_EQ(t.Hash(), s.Hash());
+
+	byte_vec b = new u_char[2];
+	b[0] = 'h';
+	b[1] = 'i';
+	s.Adopt(b, 2);
+	CHECK_EQ(s.Hash(), HashKey::HashBytes("hi", 2));
+
+	HashKey k(&s);
+	CHECK_EQ(k.Hash(), HashKey::HashBytes("hi", 2));
+	}
+
 void BroString::Adopt(byte_vec bytes, int len)
 	{
 	Reset();
@@ -281,6 +330,8 @@ istream& BroString::Read(istream &is, int format)
 
 void BroString::ToUpper()
 	{
+	hash_cached = 0;
+
 	for ( int i = 0; i < n; ++i )
 		if ( islower(b[i]) )
 			b[i] = toupper(b[i]);
@@ -51,6 +51,13 @@ public:
 	byte_vec Bytes() const	{ return b; }
 	int Len() const	{ return n; }
 
+	// Returns the same hash that HashKey computes for the string's
+	// bytes.  It's computed on first use and kept until the contents
+	// change through one of the member functions below, so code
+	// writing through Bytes() must not do so once the string may have
+	// been hashed.
+	uint64_t Hash() const;
+
 	// Releases the string's current contents, if any, and
 	// adopts the byte vector of given length.  The string will
 	// manage the memory occupied by the string afterwards.
@@ -148,6 +155,8 @@ protected:
 	int n;
 	unsigned int final_NUL:1;	// whether we have added a final NUL
 	unsigned int use_free_to_delete:1;	// free() vs. operator delete
+	mutable unsigned int hash_cached:1;	// whether "hash" is valid
+	mutable uint64_t hash;
 };
 
 // A comparison class that sorts pointers to BroString's according to
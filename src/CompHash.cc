@@ -39,6 +39,26 @@ CompositeHash::CompositeHash(TypeList* composite_type)
 		is_complex_type = 0;
 		}
 
+	is_atomic = true;
+
+	for ( const auto& t : *type->Types() )
+		{
+		switch ( t->InternalType() ) {
+		case TYPE_INTERNAL_VOID:
+		case TYPE_INTERNAL_OTHER:
+			if ( t->Tag() != TYPE_FUNC )
+				is_atomic = false;
+			break;
+
+		case TYPE_INTERNAL_ERROR:
+			is_atomic = false;
+			break;
+
+		default:
+			break;
+		}
+		}
+
 	if ( is_singleton )
 		{
 		// Don't do any further key computations - we'll do them
@@ -416,6 +436,161 @@ HashKey* CompositeHash::ComputeSingletonHash(const Val* v, int type_check) const
 	}
 	}
 
+bool CompositeHash::ComputeTransientHash(const Val* const* vals, int n,
+					 int type_check, const void*& k,
+					 int& k_size, hash_t& hash) const
+	{
+	if ( ! is_atomic )
+		reporter->InternalError("CompositeHash::ComputeTransientHash on non-atomic index");
+
+	if ( is_singleton )
+		{
+		if ( type_check && n != 1 )
+			return false;
+
+		return ComputeTransientSingletonHash(vals[0], type_check,
+						     k, k_size, hash);
+		}
+
+	const type_list* tl = type->Types();
+
+	if ( type_check && n != tl->length() )
+		return false;
+
+	// For fixed-size keys, "size" already is an upper bound.
+	int sz = size;
+
+	if ( ! key )
+		{
+		sz = 0;
+
+		for ( int i = 0; i < n; ++i )
+			{
+			sz = SingleTypeKeySize((*tl)[i], vals[i], type_check,
+					       sz, false, false);
+			if ( ! sz )
+				return false;
+			}
+
+		type_check = 0;	// no need to type-check again.
+		}
+
+	char* kb = ScratchSpace(sz);
+	char* kp = kb;
+
+	for ( int i = 0; i < n; ++i )
+		{
+		// Atomic values aren't modified by SingleValHash().
+		kp = SingleValHash(type_check, kp, (*tl)[i],
+				   const_cast<Val*>(vals[i]), false);
+		if ( ! kp )
+			return false;
+		}
+
+	k = kb;
+	k_size = kp - kb;
+	hash = HashKey::HashBytes(k, k_size);
+	return true;
+	}
+
+bool CompositeHash::ComputeTransientSingletonHash(const Val* v, int type_check,
+						  const void*& k, int& k_size,
+						  hash_t& hash) const
+	{
+	if ( type_check && v->Type()->InternalType() != singleton_tag )
+		return false;
+
+	// The keys and hashes computed here need to match exactly what
+	// ComputeSingletonHash() produces for the same value.
+	switch ( singleton_tag ) {
+	case TYPE_INTERNAL_INT:
+	case TYPE_INTERNAL_UNSIGNED:
+		{
+		bro_int_t* kp = reinterpret_cast<bro_int_t*>(ScratchSpace(sizeof(bro_int_t)));
+		*kp = v->ForceAsInt();
+		k = kp;
+		k_size = sizeof(*kp);
+		hash = HashKey::HashFixedBytes(k, k_size);
+		return true;
+		}
+
+	case TYPE_INTERNAL_ADDR:
+		{
+		uint32_t* kp = reinterpret_cast<uint32_t*>(ScratchSpace(4 * sizeof(uint32_t)));
+		v->AsAddr().CopyIPv6(kp);
+		k = kp;
+		k_size = 4 * sizeof(uint32_t);
+		hash = HashKey::HashFixedBytes(k, k_size);
+		return true;
+		}
+
+	case TYPE_INTERNAL_SUBNET:
+		{
+		uint32_t* kp = reinterpret_cast<uint32_t*>(ScratchSpace(5 * sizeof(uint32_t)));
+		v->AsSubNet().Prefix().CopyIPv6(kp);
+		kp[4] = v->AsSubNet().Length();
+		k = kp;
+		k_size = 5 * sizeof(uint32_t);
+		hash = HashKey::HashBytes(k, k_size);
+		return true;
+		}
+
+	case TYPE_INTERNAL_DOUBLE:
+		{
+		double* kp = reinterpret_cast<double*>(ScratchSpace(sizeof(double)));
+		*kp = v->InternalDouble();
+		k = kp;
+		k_size = sizeof(*kp);
+		hash = HashKey::HashFixedBytes(k, k_size);
+		return true;
+		}
+
+	case TYPE_INTERNAL_VOID:
+	case TYPE_INTERNAL_OTHER:
+		{
+		if ( v->Type()->Tag() != TYPE_FUNC )
+			reporter->InternalError("bad index type in CompositeHash::ComputeTransientSingletonHash");
+
+		uint32_t* kp = reinterpret_cast<uint32_t*>(ScratchSpace(sizeof(uint32_t)));
+		*kp = v->AsFunc()->GetUniqueFuncID();
+		k = kp;
+		k_size = sizeof(*kp);
+		hash = HashKey::HashFixedBytes(k, k_size);
+		return true;
+		}
+
+	case TYPE_INTERNAL_STRING:
+		{
+		const BroString* s = v->AsString();
+		k = s->Bytes();
+		k_size = s->Len();
+		hash = s->Hash();
+		return true;
+		}
+
+	case TYPE_INTERNAL_ERROR:
+		return false;
+
+	default:
+		reporter->InternalError("bad internal type in CompositeHash::ComputeTransientSingletonHash");
+		return false;
+	}
+	}
+
+char* CompositeHash::ScratchSpace(int size)
+	{
+	// Backed by doubles so that it's suitably aligned, just like the
+	// buffers ComputeHash() allocates.
+	static thread_local std::vector<double> scratch;
+
+	size_t n = size / sizeof(double) + 1;
+
+	if ( scratch.size() < n )
+		scratch.resize(n);
+
+	return reinterpret_cast<char*>(scratch.data());
+	}
+
 int CompositeHash::SingleTypeKeySize(BroType* bt, const Val* v,
 				     int type_check, int sz, bool optional,
 				     bool calc_static_size) const
@@ -16,6 +16,21 @@ public:
 	// or 0 if it fails to typecheck.
 	HashKey* ComputeHash(const Val* v, int type_check) const;
 
+	// Returns true if the index consists only of atomic types (no
+	// records, tables, vectors or lists), in which case it can be
+	// hashed with ComputeTransientHash().
+	bool IsAtomic() const	{ return is_atomic; }
+
+	// Like ComputeHash(), but for an index given as an array of n values
+	// and without allocating: multi-part keys are encoded into reusable
+	// per-thread scratch space, and singleton keys may point into the
+	// value itself.  The key is therefore only valid until the next call
+	// and must be copied if it needs to be kept.  Requires IsAtomic().
+	// Returns false if the values fail to typecheck.
+	bool ComputeTransientHash(const Val* const* vals, int n, int type_check,
+				  const void*& key, int& key_size,
+				  hash_t& hash) const;
+
 	// Given a hash key, recover the values used to create it.
 	ListVal* RecoverVals(const HashKey* k) const;
 
@@ -24,6 +39,14 @@ public:
 protected:
 	HashKey* ComputeSingletonHash(const Val* v, int type_check) const;
 
+	bool ComputeTransientSingletonHash(const Val* v, int type_check,
+					   const void*& key, int& key_size,
+					   hash_t& hash) const;
+
+	// Returns per-thread scratch space of at least the given size,
+	// aligned for any of the types making up a key.
+	static char* ScratchSpace(int size);
+
 	// Computes the piece of the hash for Val*, returning the new kp.
 	// Used as a helper for ComputeHash in the non-singleton case.
 	char* SingleValHash(int type_check, char* kp, BroType* bt, Val* v,
@@ -86,5 +109,8 @@ protected:
 	// If one type, but not normal "singleton", e.g. record.
 	int is_complex_type;
 
+	// If all types are atomic; see IsAtomic().
+	bool is_atomic;
+
 	InternalTypeTag singleton_tag;
 };
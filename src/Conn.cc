@@ -16,6 +16,8 @@
 #include "TunnelEncapsulation.h"
 #include "analyzer/Analyzer.h"
 #include "analyzer/Manager.h"
+#include "iosource/Manager.h"
+#include "iosource/PktSrc.h"
 
 void ConnectionTimer::Init(Connection* arg_conn, timer_func arg_timer,
 				int arg_do_expire)
@@ -92,6 +94,8 @@ Connection::Connection(NetSessions* s, const ConnIDKey& k, double t, const ConnI
 
 	is_active = 1;
 	skip = 0;
+	bypassed = 0;
+	bypassed_pkts = bypassed_bytes = 0;
 	weird = 0;
 
 	suppress_event = 0;
@@ -225,6 +229,20 @@ void Connection::NextPacket(double t, int is_orig,
 	current_pkt = 0;
 	}
 
+void Connection::Bypass()
+	{
+	if ( bypassed )
+		return;
+
+	bypassed = 1;
+
+	const iosource::Manager::PktSrcList& pkt_srcs(iosource_mgr->GetPktSrcs());
+
+	for ( iosource::Manager::PktSrcList::const_iterator i = pkt_srcs.begin();
+	      i != pkt_srcs.end(); i++ )
+		(*i)->BypassConnection(this);
+	}
+
 void Connection::SetLifetime(double lifetime)
 	{
 	ADD_TIMER(&Connection::DeleteTimer, network_time + lifetime, 0,
@@ -406,6 +424,12 @@ RecordVal* Connection::BuildConnVal()
 	conn_val->Assign(6, new StringVal(history.c_str()));
 	conn_val->Assign(11, val_mgr->GetBool(is_successful));
 
+	if ( bypassed )
+		{
+		conn_val->Assign(12, val_mgr->GetCount(bypassed_pkts));
+		conn_val->Assign(13, val_mgr->GetCount(bypassed_bytes));
+		}
+
 	conn_val->SetOrigin(this);
 
 	Ref(conn_val);
@@ -142,6 +142,20 @@ public:
 	void SetSkip(int do_skip)		{ skip = do_skip; }
 	int Skipping() const			{ return skip; }
 
+	// Stops all processing of the connection's packets except for
+	// counting them and keeping the connection alive; no analyzers
+	// see them anymore.  Packet sources are asked to drop the
+	// connection's packets themselves if they are able to.
+	void Bypass();
+	int Bypassed() const			{ return bypassed; }
+
+	// Accounts for a packet that arrived while bypassing.
+	void BypassedPacket(double t, uint32_t len)
+		{ last_time = t; ++bypassed_pkts; bypassed_bytes += len; }
+
+	uint64_t BypassedPackets() const	{ return bypassed_pkts; }
+	uint64_t BypassedBytes() const		{ return bypassed_bytes; }
+
 	// Arrange for the connection to expire after the given amount of time.
 	void SetLifetime(double lifetime);
 
@@ -342,6 +356,7 @@ protected:
 	unsigned int timers_canceled:1;
 	unsigned int is_active:1;
 	unsigned int skip:1;
+	unsigned int bypassed:1;
 	unsigned int weird:1;
 	unsigned int finished:1;
 	unsigned int record_packets:1, record_contents:1;
@@ -357,6 +372,9 @@ protected:
 	string history;
 	uint32_t hist_seen;
 
+	uint64_t bypassed_pkts;
+	uint64_t bypassed_bytes;
+
 	analyzer::TransportLayerAnalyzer* root_analyzer;
 	analyzer::pia::PIA* primary_PIA;
 
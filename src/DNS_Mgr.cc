@@ -33,6 +33,7 @@
 #include "Event.h"
 #include "Net.h"
 #include "Var.h"
+#include "NetVar.h"
 #include "Reporter.h"
 #include "iosource/Manager.h"
 #include "digest.h"
@@ -46,6 +47,9 @@ extern int select(int, fd_set *, fd_set *, fd_set *, struct timeval *);
 }
 
 
+// Default number of requests outstanding at the same time.
+#define MAX_PENDING_REQUESTS 20
+
 class DNS_Mgr_Request {
 public:
 	DNS_Mgr_Request(const char* h, int af, bool is_txt)
@@ -63,6 +67,7 @@ public:
 	const char* ReqHost() const	{ return host; }
 	const IPAddr& ReqAddr() const		{ return addr; }
 	const bool ReqIsTxt() const	{ return qtype == 16; }
+	int ReqFamily() const		{ return fam; }
 
 	int MakeRequest(nb_dns_info* nb_dns);
 	int RequestPending() const	{ return request_pending; }
@@ -128,7 +133,7 @@ public:
 
 	bool Expired() const
 		{
-		if ( req_host && num_addrs == 0)
+		if ( req_host && num_addrs == 0 && ! failed )
 			return false; // nothing to expire
 
 		return current_time() > (creation_time + req_ttl);
@@ -160,6 +165,10 @@ protected:
 	int failed;
 	double creation_time;
 	int map_type;
+
+	// Position in DNS_Mgr's LRU list, if cached is set.
+	bool cached;
+	list<DNS_Mapping*>::iterator lru_pos;
 };
 
 void DNS_Mgr_mapping_delete_func(void* v)
@@ -317,6 +326,7 @@ void DNS_Mapping::Init(struct hostent* h)
 	creation_time = current_time();
 	host_val = 0;
 	addrs_val = 0;
+	cached = false;
 
 	if ( ! h )
 		{
@@ -359,6 +369,7 @@ void DNS_Mapping::Clear()
 	no_mapping = 0;
 	map_type = 0;
 	failed = 1;
+	cached = false;
 	}
 
 void DNS_Mapping::Save(FILE* f) const
@@ -388,9 +399,19 @@ DNS_Mgr::DNS_Mgr(DNS_MgrMode arg_mode)
 	cache_name = dir = 0;
 
 	asyncs_pending = 0;
+	max_pending = MAX_PENDING_REQUESTS;
+	max_queued = 0;
+	negative_ttl = 0;
+	max_cached = 0;
+
 	num_requests = 0;
 	successful = 0;
 	failed = 0;
+	num_coalesced = 0;
+	num_cache_hits = 0;
+	num_negative_hits = 0;
+	num_evicted = 0;
+	num_dropped = 0;
 	nb_dns = nullptr;
 	next_timestamp = -1.0;
 	}
@@ -416,6 +437,8 @@ void DNS_Mgr::Init()
 	// the lookup.
 	auto dns_resolver = zeekenv("ZEEK_DNS_RESOLVER");
 	auto dns_resolver_addr = dns_resolver ? IPAddr(dns_resolver) : IPAddr();
+	auto dns_resolver_port = zeekenv("ZEEK_DNS_RESOLVER_PORT");
+	uint16_t port = dns_resolver_port ? atoi(dns_resolver_port) : 0;
 	char err[NB_DNS_ERRSIZE];
 
 	if ( dns_resolver_addr == IPAddr() )
@@ -429,12 +452,14 @@ void DNS_Mgr::Init()
 			struct sockaddr_in* sa = (struct sockaddr_in*)&ss;
 			sa->sin_family = AF_INET;
 			dns_resolver_addr.CopyIPv4(&sa->sin_addr);
+			sa->sin_port = htons(port);
 			}
 		else
 			{
 			struct sockaddr_in6* sa = (struct sockaddr_in6*)&ss;
 			sa->sin6_family = AF_INET6;
 			dns_resolver_addr.CopyIPv6(&sa->sin6_addr);
+			sa->sin6_port = htons(port);
 			}
 
 		nb_dns = nb_dns_init2(err, (struct sockaddr*)&ss);
@@ -457,6 +482,15 @@ void DNS_Mgr::InitPostScript()
 
 	dm_rec = internal_type("dns_mapping")->AsRecordType();
 
+	max_pending = std::max(int(BifConst::dns_resolver_max_pending), 1);
+	max_queued = BifConst::dns_resolver_max_queued;
+	negative_ttl = BifConst::dns_resolver_negative_ttl;
+	max_cached = BifConst::dns_resolver_cache_size;
+
+	// A host lookup needs room for both its A and AAAA mappings.
+	if ( max_cached == 1 )
+		max_cached = 2;
+
 	// Registering will call Init()
 	iosource_mgr->Register(this, true);
 
@@ -604,8 +638,6 @@ void DNS_Mgr::Verify()
 	{
 	}
 
-#define MAX_PENDING_REQUESTS 20
-
 void DNS_Mgr::Resolve()
 	{
 	if ( ! nb_dns )
@@ -762,6 +794,10 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 	DNS_Mapping* prev_dm;
 	int keep_prev = 0;
 
+	// A failed lookup is cached for the negative TTL, if any.
+	if ( ! h )
+		ttl = negative_ttl;
+
 	if ( dr->ReqHost() )
 		{
 		new_dm = new DNS_Mapping(dr->ReqHost(), h, ttl);
@@ -787,6 +823,12 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 			}
 		else
 			{
+			// Keep failed lookups apart by address family, so that
+			// the A and AAAA results of a name don't overwrite each
+			// other.
+			if ( ! h )
+				new_dm->map_type = dr->ReqFamily();
+
 			HostMap::iterator it = host_mappings.find(dr->ReqHost());
 			if ( it == host_mappings.end() )
 				{
@@ -841,9 +883,83 @@ void DNS_Mgr::AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r)
 		CompareMappings(prev_dm, new_dm);
 
 	if ( keep_prev )
+		{
 		delete new_dm;
+		TouchMapping(prev_dm);
+		}
 	else
-		delete prev_dm;
+		{
+		DeleteMapping(prev_dm);
+		TouchMapping(new_dm);
+		}
+
+	EvictMappings();
+	}
+
+void DNS_Mgr::TouchMapping(DNS_Mapping* dm)
+	{
+	if ( dm->cached )
+		mappings_lru.splice(mappings_lru.begin(), mappings_lru, dm->lru_pos);
+	else
+		{
+		dm->lru_pos = mappings_lru.insert(mappings_lru.begin(), dm);
+		dm->cached = true;
+		}
+	}
+
+void DNS_Mgr::DeleteMapping(DNS_Mapping* dm)
+	{
+	if ( ! dm )
+		return;
+
+	if ( dm->cached )
+		mappings_lru.erase(dm->lru_pos);
+
+	delete dm;
+	}
+
+void DNS_Mgr::EvictMappings()
+	{
+	if ( max_cached == 0 )
+		return;
+
+	while ( mappings_lru.size() > max_cached )
+		{
+		DNS_Mapping* dm = mappings_lru.back();
+
+		if ( ! dm->ReqHost() )
+			{
+			AddrMap::iterator it = addr_mappings.find(dm->ReqAddr());
+			if ( it != addr_mappings.end() && it->second == dm )
+				addr_mappings.erase(it);
+			}
+		else
+			{
+			TextMap::iterator it = text_mappings.find(dm->ReqHost());
+
+			if ( it != text_mappings.end() && it->second == dm )
+				text_mappings.erase(it);
+			else
+				{
+				HostMap::iterator it2 = host_mappings.find(dm->ReqHost());
+
+				if ( it2 != host_mappings.end() )
+					{
+					if ( it2->second.first == dm )
+						it2->second.first = 0;
+
+					if ( it2->second.second == dm )
+						it2->second.second = 0;
+
+					if ( ! it2->second.first && ! it2->second.second )
+						host_mappings.erase(it2);
+					}
+				}
+			}
+
+		DeleteMapping(dm);
+		++num_evicted;
+		}
 	}
 
 void DNS_Mgr::CompareMappings(DNS_Mapping* prev_dm, DNS_Mapping* new_dm)
@@ -958,8 +1074,12 @@ void DNS_Mgr::LoadCache(FILE* f)
 			{
 			addr_mappings[m->ReqAddr()] = m;
 			}
+
+		TouchMapping(m);
 		}
 
+	EvictMappings();
+
 	if ( ! m->NoMapping() )
 		reporter->FatalError("DNS cache corrupted");
 
@@ -1002,10 +1122,12 @@ const char* DNS_Mgr::LookupAddrInCache(const IPAddr& addr)
 	if ( d->Expired() )
 		{
 		addr_mappings.erase(it);
-		delete d;
+		DeleteMapping(d);
 		return 0;
 		}
 
+	TouchMapping(d);
+
 	// The escapes in the following strings are to avoid having it
 	// interpreted as a trigraph sequence.
 	return d->names ? d->names[0] : "<\?\?\?>";
@@ -1029,11 +1151,14 @@ TableVal* DNS_Mgr::LookupNameInCache(const string& name)
 	if ( d4->Expired() || d6->Expired() )
 		{
 		host_mappings.erase(it);
-		delete d4;
-		delete d6;
+		DeleteMapping(d4);
+		DeleteMapping(d6);
 		return 0;
 		}
 
+	TouchMapping(d4);
+	TouchMapping(d6);
+
 	TableVal* tv4 = d4->AddrsSet();
 	TableVal* tv6 = d6->AddrsSet();
 	tv4->AddTo(tv6, false);
@@ -1052,10 +1177,12 @@ const char* DNS_Mgr::LookupTextInCache(const string& name)
 	if ( d->Expired() )
 		{
 		text_mappings.erase(it);
-		delete d;
+		DeleteMapping(d);
 		return 0;
 		}
 
+	TouchMapping(d);
+
 	// The escapes in the following strings are to avoid having it
 	// interpreted as a trigraph sequence.
 	return d->names ? d->names[0] : "<\?\?\?>";
@@ -1076,6 +1203,30 @@ static void resolve_lookup_cb(DNS_Mgr::LookupCallback* callback,
 	delete callback;
 	}
 
+bool DNS_Mgr::NegativeNameInCache(const string& name)
+	{
+	HostMap::iterator it = host_mappings.find(name);
+	if ( it == host_mappings.end() )
+		return false;
+
+	DNS_Mapping* d4 = it->second.first;
+	DNS_Mapping* d6 = it->second.second;
+
+	return d4 && d6 && d4->Failed() && d6->Failed() &&
+	       ! d4->Expired() && ! d6->Expired();
+	}
+
+bool DNS_Mgr::QueueFull(LookupCallback* callback)
+	{
+	if ( max_queued == 0 || asyncs_queued.size() < max_queued )
+		return false;
+
+	++num_dropped;
+	callback->Timeout();
+	delete callback;
+	return true;
+	}
+
 void DNS_Mgr::AsyncLookupAddr(const IPAddr& host, LookupCallback* callback)
 	{
 	Init();
@@ -1090,6 +1241,11 @@ void DNS_Mgr::AsyncLookupAddr(const IPAddr& host, LookupCallback* callback)
 	const char* name = LookupAddrInCache(host);
 	if ( name )
 		{
+		++num_cache_hits;
+
+		if ( addr_mappings[host]->Failed() )
+			++num_negative_hits;
+
 		resolve_lookup_cb(callback, name);
 		return;
 		}
@@ -1099,9 +1255,15 @@ void DNS_Mgr::AsyncLookupAddr(const IPAddr& host, LookupCallback* callback)
 	// Have we already a request waiting for this host?
 	AsyncRequestAddrMap::iterator i = asyncs_addrs.find(host);
 	if ( i != asyncs_addrs.end() )
+		{
 		req = i->second;
+		++num_coalesced;
+		}
 	else
 		{
+		if ( QueueFull(callback) )
+			return;
+
 		// A new one.
 		req = new AsyncRequest;
 		req->host = host;
@@ -1128,18 +1290,34 @@ void DNS_Mgr::AsyncLookupName(const string& name, LookupCallback* callback)
 	TableVal* addrs = LookupNameInCache(name);
 	if ( addrs )
 		{
+		++num_cache_hits;
 		resolve_lookup_cb(callback, addrs);
 		return;
 		}
 
+	if ( NegativeNameInCache(name) )
+		{
+		++num_cache_hits;
+		++num_negative_hits;
+		callback->Timeout();
+		delete callback;
+		return;
+		}
+
 	AsyncRequest* req = 0;
 
 	// Have we already a request waiting for this host?
 	AsyncRequestNameMap::iterator i = asyncs_names.find(name);
 	if ( i != asyncs_names.end() )
+		{
 		req = i->second;
+		++num_coalesced;
+		}
 	else
 		{
+		if ( QueueFull(callback) )
+			return;
+
 		// A new one.
 		req = new AsyncRequest;
 		req->name = name;
@@ -1167,6 +1345,11 @@ void DNS_Mgr::AsyncLookupNameText(const string& name, LookupCallback* callback)
 
 	if ( txt )
 		{
+		++num_cache_hits;
+
+		if ( text_mappings[name]->Failed() )
+			++num_negative_hits;
+
 		resolve_lookup_cb(callback, txt);
 		return;
 		}
@@ -1176,9 +1359,15 @@ void DNS_Mgr::AsyncLookupNameText(const string& name, LookupCallback* callback)
 	// Have we already a request waiting for this host?
 	AsyncRequestTextMap::iterator i = asyncs_texts.find(name);
 	if ( i != asyncs_texts.end() )
+		{
 		req = i->second;
+		++num_coalesced;
+		}
 	else
 		{
+		if ( QueueFull(callback) )
+			return;
+
 		// A new one.
 		req = new AsyncRequest;
 		req->name = name;
@@ -1205,7 +1394,7 @@ static bool DoRequest(nb_dns_info* nb_dns, DNS_Mgr_Request* dr)
 
 void DNS_Mgr::IssueAsyncRequests()
 	{
-	while ( asyncs_queued.size() && asyncs_pending < MAX_PENDING_REQUESTS )
+	while ( asyncs_queued.size() && asyncs_pending < max_pending )
 		{
 		AsyncRequest* req = asyncs_queued.front();
 		asyncs_queued.pop_front();
@@ -1387,6 +1576,7 @@ void DNS_Mgr::Flush()
 	host_mappings.clear();
 	addr_mappings.clear();
 	text_mappings.clear();
+	mappings_lru.clear();
 	}
 
 void DNS_Mgr::Process()
@@ -1421,19 +1611,26 @@ void DNS_Mgr::DoProcess()
 		delete req;
 		}
 
-	if ( AnswerAvailable(0) <= 0 )
-		return;
+	// Take in all of the answers that have arrived instead of one per
+	// call, so that a burst of replies doesn't queue up behind the main
+	// loop.  A host lookup gets up to two answers (A and AAAA), which
+	// bounds the work per call.
+	for ( int n = 0; n < 2 * max_pending && AnswerAvailable(0) > 0; ++n )
+		{
+		char err[NB_DNS_ERRSIZE];
+		struct nb_dns_result r;
 
-	char err[NB_DNS_ERRSIZE];
-	struct nb_dns_result r;
+		int status = nb_dns_activity(nb_dns, &r, err);
 
-	int status = nb_dns_activity(nb_dns, &r, err);
+		if ( status < 0 )
+			{
+			reporter->Warning("NB-DNS error in DNS_Mgr::Process (%s)", err);
+			break;
+			}
 
-	if ( status < 0 )
-		reporter->Warning("NB-DNS error in DNS_Mgr::Process (%s)", err);
+		if ( status == 0 )
+			continue;
 
-	else if ( status > 0 )
-		{
 		DNS_Mgr_Request* dr = (DNS_Mgr_Request*) r.cookie;
 
 		bool do_host_timeout = true;
@@ -1511,5 +1708,11 @@ void DNS_Mgr::GetStats(Stats* stats)
 	stats->cached_hosts = host_mappings.size();
 	stats->cached_addresses = addr_mappings.size();
 	stats->cached_texts = text_mappings.size();
+	stats->queued = asyncs_queued.size();
+	stats->coalesced = num_coalesced;
+	stats->cache_hits = num_cache_hits;
+	stats->negative_hits = num_negative_hits;
+	stats->evicted = num_evicted;
+	stats->dropped = num_dropped;
 	}
 
@@ -87,6 +87,12 @@ public:
 		unsigned long cached_hosts;
 		unsigned long cached_addresses;
 		unsigned long cached_texts;
+		unsigned long queued;	// waiting for a free request slot
+		unsigned long coalesced;	// joined an outstanding request
+		unsigned long cache_hits;	// async lookups answered from cache
+		unsigned long negative_hits;	// ... of which were failures
+		unsigned long evicted;	// mappings dropped to bound the cache
+		unsigned long dropped;	// lookups failed because the queue was full
 	};
 
 	void GetStats(Stats* stats);
@@ -102,6 +108,20 @@ protected:
 	Val* BuildMappingVal(DNS_Mapping* dm);
 
 	void AddResult(DNS_Mgr_Request* dr, struct nb_dns_result* r);
+
+	// Maintain the LRU order of the cached mappings, which bounds the
+	// size of the cache if dns_resolver_cache_size is set.
+	void TouchMapping(DNS_Mapping* dm);
+	void DeleteMapping(DNS_Mapping* dm);
+	void EvictMappings();
+
+	// Returns true if the name's last lookup failed and the failure
+	// is still to be cached.
+	bool NegativeNameInCache(const string& name);
+
+	// Returns true if there's no more room for queuing a new async
+	// request, in which case the callback has been timed out.
+	bool QueueFull(LookupCallback* callback);
 	void CompareMappings(DNS_Mapping* prev_dm, DNS_Mapping* new_dm);
 	ListVal* AddrListDelta(ListVal* al1, ListVal* al2);
 	void DumpAddrList(FILE* f, ListVal* al);
@@ -146,6 +166,10 @@ protected:
 
 	DNS_mgr_request_list requests;
 
+	// Cached mappings, most recently used first.
+	typedef list<DNS_Mapping*> MappingList;
+	MappingList mappings_lru;
+
 	nb_dns_info* nb_dns;
 	char* cache_name;
 	char* dir;	// directory in which cache_name resides
@@ -238,9 +262,20 @@ protected:
 
 	int asyncs_pending;
 
+	// Limits, see the dns_resolver_* options.
+	int max_pending;
+	unsigned long max_queued;
+	double negative_ttl;
+	unsigned long max_cached;
+
 	unsigned long num_requests;
 	unsigned long successful;
 	unsigned long failed;
+	unsigned long num_coalesced;
+	unsigned long num_cache_hits;
+	unsigned long num_negative_hits;
+	unsigned long num_evicted;
+	unsigned long num_dropped;
 	double next_timestamp;
 };
 
@@ -134,6 +134,57 @@ void Dictionary::DeInit()
 	}
 
 void* Dictionary::Lookup(const void* key, int key_size, hash_t hash) const
+	{
+	DictEntry* entry = LookupEntry(key, key_size, hash);
+	return entry ? entry->value : 0;
+	}
+
+const void* Dictionary::LookupKey(const void* key, int key_size, hash_t hash) const
+	{
+	DictEntry* entry = LookupEntry(key, key_size, hash);
+	return entry ? entry->key : 0;
+	}
+
+int64_t Dictionary::IterationPosition(const void* key, int key_size,
+					hash_t hash) const
+	{
+	if ( ! tbl && ! tbl2 )
+		return -1;
+
+	// Iteration walks the buckets in order, each chain front to back,
+	// and, while resizing, the second table after the first.
+	int64_t b;
+	PList<DictEntry>* chain;
+
+	hash_t h = hash % num_buckets;
+	if ( ! tbl2 || h >= tbl_next_ind )
+		{
+		b = h;
+		chain = tbl[h];
+		}
+	else
+		{
+		b = num_buckets + hash % num_buckets2;
+		chain = tbl2[hash % num_buckets2];
+		}
+
+	if ( chain )
+		{
+		for ( int i = 0; i < chain->length(); ++i )
+			{
+			DictEntry* entry = (*chain)[i];
+
+			if ( entry->hash == hash && entry->len == key_size &&
+			     ! memcmp(key, entry->key, key_size) )
+				return (b << 32) | i;
+			}
+		}
+
+	return -1;
+	}
+
+// private
+DictEntry* Dictionary::LookupEntry(const void* key, int key_size, hash_t hash) const
 	{
 	if ( ! tbl && ! tbl2 )
 		return 0;
@@ -156,7 +207,7 @@ void* Dictionary::Lookup(const void* key, int key_size, hash_t hash) const
 
 			if ( entry->hash == hash && entry->len == key_size &&
 			     ! memcmp(key, entry->key, key_size) )
-				return entry->value;
+				return entry;
 			}
 		}
 
@@ -33,6 +33,17 @@ public:
 		{ return Lookup(key->Key(), key->Size(), key->Hash()); }
 	void* Lookup(const void* key, int key_size, hash_t hash) const;
 
+	// Returns the dictionary's own copy of the given key's bytes, or 0
+	// if the key isn't present.  The pointer remains valid for as long
+	// as the entry stays in the dictionary.
+	const void* LookupKey(const void* key, int key_size, hash_t hash) const;
+
+	// Returns a number that orders the given key relative to the others
+	// the way an iteration started now would visit them, or -1 if the
+	// key isn't present.  Only valid until the dictionary changes.
+	int64_t IterationPosition(const void* key, int key_size,
+					hash_t hash) const;
+
 	// Returns previous value, or 0 if none.
 	void* Insert(HashKey* key, void* val)
 		{
@@ -127,6 +138,8 @@ private:
 	// Internal version of Insert().
 	void* Insert(DictEntry* entry, int copy_key);
 
+	DictEntry* LookupEntry(const void* key, int key_size, hash_t hash) const;
+
 	void* DoRemove(DictEntry* entry, hash_t h,
 			PList<DictEntry>* chain, int chain_offset);
 
@@ -194,6 +207,8 @@ public:
 		}
 	T* Lookup(const HashKey* key) const
 		{ return (T*) Dictionary::Lookup(key); }
+	T* Lookup(const void* key, int key_size, hash_t hash) const
+		{ return (T*) Dictionary::Lookup(key, key_size, hash); }
 	T* Insert(const char* key, T* val)
 		{
 		HashKey h(key);
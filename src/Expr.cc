@@ -2608,6 +2608,9 @@ Val* IndexExpr::Eval(Frame* f) const
 	if ( ! v1 )
 		return 0;
 
+	if ( v1->Type()->Tag() == TYPE_TABLE && ! IsError() )
+		return EvalTableIndex(f, v1->AsTableVal());
+
 	Val* v2 = op2->Eval(f);
 	if ( ! v2 )
 		{
@@ -2659,6 +2662,61 @@ Val* IndexExpr::Eval(Frame* f) const
 	return result;
 	}
 
+Val* IndexExpr::EvalTableIndex(Frame* f, TableVal* tv) const
+	{
+	// Evaluates the index values individually so that the table can
+	// look them up without first assembling them into a ListVal.
+	const expr_list& exprs = op2->AsListExpr()->Exprs();
+	int n = exprs.length();
+
+	if ( n > MAX_INLINE_INDEX_VALS )
+		{
+		Val* v2 = op2->Eval(f);
+		if ( ! v2 )
+			{
+			Unref(tv);
+			return 0;
+			}
+
+		Val* result = Fold(tv, v2);
+		Unref(tv);
+		Unref(v2);
+		return result;
+		}
+
+	Val* vals[MAX_INLINE_INDEX_VALS];
+
+	for ( int i = 0; i < n; ++i )
+		{
+		vals[i] = exprs[i]->Eval(f);
+
+		if ( ! vals[i] )
+			{
+			for ( int j = 0; j < i; ++j )
+				Unref(vals[j]);
+
+			Unref(tv);
+			RuntimeError("uninitialized list value");
+			return 0;
+			}
+		}
+
+	Val* v = tv->Lookup(vals, n);
+
+	if ( v )
+		v->Ref();
+
+	for ( int i = 0; i < n; ++i )
+		Unref(vals[i]);
+
+	Unref(tv);
+
+	if ( ! v )
+		RuntimeError("no such index");
+
+	return v;
+	}
+
 static int get_slice_index(int idx, int len)
 	{
 	if ( abs(idx) > len )
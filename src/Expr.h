@@ -635,6 +635,10 @@ protected:
 
 class IndexExpr : public BinaryExpr {
 public:
+	// Table lookups with up to this many index values don't need to
+	// build a ListVal.
+	static const int MAX_INLINE_INDEX_VALS = 8;
+
 	IndexExpr(Expr* op1, ListExpr* op2, bool is_slice = false);
 
 	int CanAdd() const override;
@@ -660,6 +664,10 @@ protected:
 
 	Val* Fold(Val* v1, Val* v2) const override;
 
+	// Evaluates the index for a lookup into the given table, which
+	// is Unref()'d when done.
+	Val* EvalTableIndex(Frame* f, TableVal* tv) const;
+
 	void ExprDescribe(ODesc* d) const override;
 
 	bool is_slice;
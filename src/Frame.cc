@@ -203,6 +203,42 @@ Frame* Frame::SelectiveClone(const id_list& selection) const
 	return other;
 	}
 
+Frame* Frame::Capture(const id_list& ids) const
+	{
+	Frame* other = new Frame(size, function, func_args);
+	other->offset_map = offset_map;
+	other->CaptureClosure(closure, outer_ids);
+
+	other->call = call;
+	other->trigger = trigger;
+	if ( trigger )
+		Ref(trigger);
+
+	for ( const auto& id : ids )
+		{
+		// Values of outer IDs live in the shared closure.
+		if ( closure && IsOuterID(id) )
+			continue;
+
+		int offset = id->Offset();
+
+		if ( offset_map.size() )
+			{
+			auto where = offset_map.find(std::string(id->Name()));
+			if ( where != offset_map.end() )
+				offset = where->second;
+			}
+
+		if ( offset < 0 || offset >= size )
+			continue;
+
+		if ( frame[offset] && ! other->frame[offset] )
+			other->frame[offset] = frame[offset]->Ref();
+		}
+
+	return other;
+	}
+
 broker::expected<broker::data> Frame::Serialize(const Frame* target, id_list selection)
 	{
 	broker::vector rval;
@@ -151,6 +151,23 @@ public:
 	 */
 	Frame* SelectiveClone(const id_list& selection) const;
 
+	/**
+	 * Creates a frame that shares the values associated with the IDs
+	 * in *ids* with this one. Unlike Clone() and SelectiveClone(), the
+	 * values aren't copied; the new frame just holds a reference to
+	 * each of them, so aggregates stay shared with this frame. The
+	 * cost is proportional to the number of IDs rather than to the
+	 * size of the frame's values. The new frame shares this frame's
+	 * closure, trigger and call as well.
+	 *
+	 * @param ids the IDs whose values the new frame captures. IDs
+	 * without a value in this frame are left unset.
+	 *
+	 * @return a new frame, with all values not associated with *ids*
+	 * set to null.
+	 */
+	Frame* Capture(const id_list& ids) const;
+
 	/**
 	 * Serializes the Frame into a Broker representation.
 	 *
@@ -742,6 +742,8 @@ void init_builtin_funcs()
 	ThreadStats = internal_type("ThreadStats")->AsRecordType();
 	BrokerStats = internal_type("BrokerStats")->AsRecordType();
 	ReporterStats = internal_type("ReporterStats")->AsRecordType();
+	DPDStats = internal_type("DPDStats")->AsRecordType();
+	TableExpireStats = internal_type("TableExpireStats")->AsRecordType();
 
 	var_sizes = internal_type("var_sizes")->AsTableType();
 
@@ -14,6 +14,12 @@
 // length. MD5 is used as a scrambling scheme so that it is difficult
 // for the adversary to construct conflicts, though I do not know if
 // HMAC/MD5 is provably universal.
+//
+// 3) Optionally, short keys of fixed size (integers, doubles, pointers
+// and addresses) can use a faster keyed hash modeled after wyhash's
+// multiply-and-fold mixing.  Its two 64-bit keys are derived from the
+// random SipHash key, so it remains seeded per process.  Variable-length
+// data such as strings always goes through SipHash/HMAC.
 
 #include "zeek-config.h"
 
@@ -22,11 +28,102 @@
 
 #include "siphash24.h"
 
+static bool use_fast_hash = false;
+static uint64_t fast_hash_key[2];
+
 void init_hash_function()
 	{
 	// Make sure we have already called init_random_seed().
 	if ( ! (hmac_key_set && siphash_key_set) )
 		reporter->InternalError("Zeek's hash functions aren't fully initialized");
+
+	// Derive the fast hash's keys from the SipHash key, so that
+	// they follow the same seeding (e.g., via $ZEEK_SEED_FILE).
+	for ( int i = 0; i < 2; ++i )
+		{
+		uint8_t label[] = { 'f', 'a', 's', 't', 'h', 'a', 's', 'h', uint8_t(i) };
+		siphash(&fast_hash_key[i], label, sizeof(label), shared_siphash_key);
+		}
+
+#ifdef ENABLE_FAST_HASH
+	use_fast_hash = true;
+#endif
+
+	const char* tier = zeekenv("ZEEK_HASH_TIER");
+
+	if ( tier )
+		{
+		if ( strcmp(tier, "fast") == 0 )
+			use_fast_hash = true;
+		else if ( strcmp(tier, "siphash") == 0 )
+			use_fast_hash = false;
+		else
+			reporter->FatalError("unknown hash tier '%s' in $ZEEK_HASH_TIER", tier);
+		}
+	}
+
+static inline uint64_t fast_hash_mix(uint64_t a, uint64_t b)
+	{
+#ifdef __SIZEOF_INT128__
+	__uint128_t r = (__uint128_t) a * b;
+	return uint64_t(r) ^ uint64_t(r >> 64);
+#else
+	uint64_t ha = a >> 32, hb = b >> 32;
+	uint64_t la = uint32_t(a), lb = uint32_t(b);
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32);
+	uint64_t c = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	c += lo < t;
+	uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+	return lo ^ hi;
+#endif
+	}
+
+static inline uint64_t fast_hash_read64(const uint8_t* p)
+	{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+	}
+
+static inline uint64_t fast_hash_read32(const uint8_t* p)
+	{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+	}
+
+static hash_t fast_hash(const void* bytes, int size)
+	{
+	const uint8_t* p = (const uint8_t*) bytes;
+	uint64_t a, b;
+
+	// Reads overlap for sizes that aren't a power of two, so that
+	// every byte contributes without any branching on the exact size.
+	if ( size >= 8 )
+		{
+		a = fast_hash_read64(p);
+		b = fast_hash_read64(p + size - 8);
+		}
+
+	else if ( size >= 4 )
+		{
+		a = fast_hash_read32(p);
+		b = fast_hash_read32(p + size - 4);
+		}
+
+	else if ( size > 0 )
+		{
+		a = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+		b = 0;
+		}
+
+	else
+		a = b = 0;
+
+	uint64_t h = fast_hash_mix(a ^ fast_hash_key[0], b ^ fast_hash_key[1]);
+	return fast_hash_mix(h ^ fast_hash_key[0], uint64_t(size) ^ fast_hash_key[1]);
 	}
 
 HashKey::HashKey(bro_int_t i)
@@ -34,7 +131,7 @@ HashKey::HashKey(bro_int_t i)
 	key_u.i = i;
 	key = (void*) &key_u;
 	size = sizeof(i);
-	hash = HashBytes(key, size);
+	hash = HashFixedBytes(key, size);
 	is_our_dynamic = 0;
 	}
 
@@ -43,7 +140,7 @@ HashKey::HashKey(bro_uint_t u)
 	key_u.i = bro_int_t(u);
 	key = (void*) &key_u;
 	size = sizeof(u);
-	hash = HashBytes(key, size);
+	hash = HashFixedBytes(key, size);
 	is_our_dynamic = 0;
 	}
 
@@ -52,7 +149,7 @@ HashKey::HashKey(uint32_t u)
 	key_u.u32 = u;
 	key = (void*) &key_u;
 	size = sizeof(u);
-	hash = HashBytes(key, size);
+	hash = HashFixedBytes(key, size);
 	is_our_dynamic = 0;
 	}
 
@@ -60,7 +157,7 @@ HashKey::HashKey(const uint32_t u[], int n)
 	{
 	size = n * sizeof(u[0]);
 	key = (void*) u;
-	hash = HashBytes(key, size);
+	hash = HashFixedBytes(key, size);
 	is_our_dynamic = 0;
 	}
 
@@ -74,7 +171,7 @@ HashKey::HashKey(double d)
 	key_u.d = u.d = d;
 	key = (void*) &key_u;
 	size = sizeof(d);
-	hash = HashBytes(key, size);
+	hash = HashFixedBytes(key, size);
 	is_our_dynamic = 0;
 	}
 
@@ -83,7 +180,7 @@ HashKey::HashKey(const void* p)
 	key_u.p = p;
 	key = (void*) &key_u;
 	size = sizeof(p);
-	hash = HashBytes(key, size);
+	hash = HashFixedBytes(key, size);
 	is_our_dynamic = 0;
 	}
 
@@ -99,7 +196,7 @@ HashKey::HashKey(const BroString* s)
 	{
 	size = s->Len();
 	key = (void*) s->Bytes();
-	hash = HashBytes(key, size);
+	hash = s->Hash();
 	is_our_dynamic = 0;
 	}
 
@@ -177,3 +274,16 @@ hash_t HashKey::HashBytes(const void* bytes, int size)
 	hmac_md5(size, (const unsigned char*) bytes, (unsigned char*) digest);
 	return digest[0];
 	}
+
+hash_t HashKey::HashFixedBytes(const void* bytes, int size)
+	{
+	if ( use_fast_hash && size <= FAST_HASH_KEY_SIZE )
+		return fast_hash(bytes, size);
+
+	return HashBytes(bytes, size);
+	}
+
+bool HashKey::FastHashEnabled()
+	{
+	return use_fast_hash;
+	}
@@ -8,6 +8,9 @@
 
 #define UHASH_KEY_SIZE 36
 
+// Fixed-size keys up to this many bytes may use the fast hash tier.
+#define FAST_HASH_KEY_SIZE 16
+
 typedef uint64_t hash_t;
 
 typedef enum {
@@ -68,6 +71,15 @@ public:
 	unsigned int MemoryAllocation() const	{ return padded_sizeof(*this) + pad_size(size); }
 
 	static hash_t HashBytes(const void* bytes, int size);
+
+	// Hashes a short key of fixed size (such as an integer, double,
+	// pointer, or address) using the fast keyed hash when that tier
+	// is enabled, and HashBytes() otherwise.
+	static hash_t HashFixedBytes(const void* bytes, int size);
+
+	// Returns true if fixed-size keys use the fast hash tier.
+	static bool FastHashEnabled();
+
 protected:
 	void* CopyKey(const void* key, int size) const;
 
@@ -84,4 +96,8 @@ protected:
 	hash_t hash;
 };
 
+// Initializes the hash functions and selects the hash tier used for
+// fixed-size keys.  The fast tier is the default if Zeek was configured
+// with --enable-fast-hash, and can be chosen at run-time by setting
+// $ZEEK_HASH_TIER to "fast" or "siphash".
 extern void init_hash_function();
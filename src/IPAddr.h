@@ -257,7 +257,8 @@ public:
 	 */
 	HashKey* GetHashKey() const
 		{
-		return new HashKey((void*)in6.s6_addr, sizeof(in6.s6_addr));
+		return new HashKey((void*)in6.s6_addr, sizeof(in6.s6_addr),
+				   HashKey::HashFixedBytes(in6.s6_addr, sizeof(in6.s6_addr)));
 		}
 
 	/**
@@ -128,6 +128,7 @@ TableVal* stp_skip_src;
 double table_expire_interval;
 double table_expire_delay;
 int table_incremental_step;
+int prefix_table_index_min_size;
 
 double connection_status_update_interval;
 
@@ -163,6 +164,7 @@ RecordType* irc_join_info;
 
 int dpd_reassemble_first_packets;
 int dpd_buffer_size;
+bro_uint_t dpd_max_total_buffer_size;
 int dpd_match_only_beginning;
 int dpd_late_match_stop;
 int dpd_ignore_ports;
@@ -207,6 +209,7 @@ void init_general_global_var()
 	table_expire_interval = opt_internal_double("table_expire_interval");
 	table_expire_delay = opt_internal_double("table_expire_delay");
 	table_incremental_step = opt_internal_int("table_incremental_step");
+	prefix_table_index_min_size = opt_internal_int("prefix_table_index_min_size");
 
 	rotate_info = internal_type("rotate_info")->AsRecordType();
 	log_rotate_base_time = opt_internal_string("log_rotate_base_time");
@@ -406,6 +409,7 @@ void init_net_var()
 	dpd_reassemble_first_packets =
 		opt_internal_int("dpd_reassemble_first_packets");
 	dpd_buffer_size = opt_internal_int("dpd_buffer_size");
+	dpd_max_total_buffer_size = opt_internal_unsigned("dpd_max_total_buffer_size");
 	dpd_match_only_beginning = opt_internal_int("dpd_match_only_beginning");
 	dpd_late_match_stop = opt_internal_int("dpd_late_match_stop");
 	dpd_ignore_ports = opt_internal_int("dpd_ignore_ports");
@@ -130,6 +130,7 @@ extern TableVal* stp_skip_src;
 extern double table_expire_interval;
 extern double table_expire_delay;
 extern int table_incremental_step;
+extern int prefix_table_index_min_size;
 
 extern int orig_addr_anonymization, resp_addr_anonymization;
 extern int other_addr_anonymization;
@@ -164,6 +165,7 @@ extern RecordType* irc_join_info;
 
 extern int dpd_reassemble_first_packets;
 extern int dpd_buffer_size;
+extern bro_uint_t dpd_max_total_buffer_size;
 extern int dpd_match_only_beginning;
 extern int dpd_late_match_stop;
 extern int dpd_ignore_ports;
@@ -25,44 +25,118 @@ void notifier::Registry::Register(Modifiable* m, notifier::Receiver* r)
 	{
 	DBG_LOG(DBG_NOTIFIERS, "registering object %p for receiver %p", m, r);
 
-	registrations.insert({m, r});
+	++registrations[m].all[r];
 	++m->num_receivers;
 	}
 
+void notifier::Registry::Register(Modifiable* m, Key key, notifier::Receiver* r)
+	{
+	DBG_LOG(DBG_NOTIFIERS, "registering object %p key %" PRIu64 " for receiver %p",
+		m, key, r);
+
+	++registrations[m].keyed[key][r];
+	++m->num_receivers;
+	}
+
+// Removes one registration of a receiver from the map, returning true if
+// there was one.
+static bool remove_receiver(std::unordered_map<notifier::Receiver*, int>& receivers,
+                            notifier::Receiver* r)
+	{
+	auto i = receivers.find(r);
+
+	if ( i == receivers.end() )
+		return false;
+
+	if ( --i->second == 0 )
+		receivers.erase(i);
+
+	return true;
+	}
+
 void notifier::Registry::Unregister(Modifiable* m, notifier::Receiver* r)
 	{
 	DBG_LOG(DBG_NOTIFIERS, "unregistering object %p from receiver %p", m, r);
 
-	auto x = registrations.equal_range(m);
-	for ( auto i = x.first; i != x.second; i++ )
-		{
-		if ( i->second == r )
-			{
-			--i->first->num_receivers;
-			registrations.erase(i);
-			break;
-			}
-		}
+	auto x = registrations.find(m);
+
+	if ( x == registrations.end() || ! remove_receiver(x->second.all, r) )
+		return;
+
+	--m->num_receivers;
+
+	if ( x->second.all.empty() && x->second.keyed.empty() )
+		registrations.erase(x);
+	}
+
+void notifier::Registry::Unregister(Modifiable* m, Key key, notifier::Receiver* r)
+	{
+	DBG_LOG(DBG_NOTIFIERS, "unregistering object %p key %" PRIu64 " from receiver %p",
+		m, key, r);
+
+	auto x = registrations.find(m);
+
+	if ( x == registrations.end() )
+		return;
+
+	auto k = x->second.keyed.find(key);
+
+	if ( k == x->second.keyed.end() || ! remove_receiver(k->second, r) )
+		return;
+
+	--m->num_receivers;
+
+	if ( k->second.empty() )
+		x->second.keyed.erase(k);
+
+	if ( x->second.all.empty() && x->second.keyed.empty() )
+		registrations.erase(x);
 	}
 
 void notifier::Registry::Unregister(Modifiable* m)
 	{
 	DBG_LOG(DBG_NOTIFIERS, "unregistering object %p from all notifiers", m);
 
-	auto x = registrations.equal_range(m);
-	for ( auto i = x.first; i != x.second; i++ )
-		--i->first->num_receivers;
-
-	registrations.erase(x.first, x.second);
+	registrations.erase(m);
+	m->num_receivers = 0;
 	}
 
 void notifier::Registry::Modified(Modifiable* m)
 	{
 	DBG_LOG(DBG_NOTIFIERS, "object %p has been modified", m);
 
-	auto x = registrations.equal_range(m);
-	for ( auto i = x.first; i != x.second; i++ )
-		i->second->Modified(m);
+	auto x = registrations.find(m);
+
+	if ( x == registrations.end() )
+		return;
+
+	for ( const auto& r : x->second.all )
+		r.first->Modified(m);
+
+	for ( const auto& k : x->second.keyed )
+		for ( const auto& r : k.second )
+			r.first->Modified(m);
+	}
+
+void notifier::Registry::Modified(Modifiable* m, Key key)
+	{
+	DBG_LOG(DBG_NOTIFIERS, "object %p key %" PRIu64 " has been modified", m, key);
+
+	auto x = registrations.find(m);
+
+	if ( x == registrations.end() )
+		return;
+
+	for ( const auto& r : x->second.all )
+		r.first->Modified(m);
+
+	auto k = x->second.keyed.find(key);
+
+	if ( k == x->second.keyed.end() )
+		return;
+
+	for ( const auto& r : k->second )
+		r.first->Modified(m);
 	}
 
 notifier::Modifiable::~Modifiable()
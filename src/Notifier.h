@@ -32,6 +32,14 @@ public:
 	virtual void Modified(Modifiable* m) = 0;
 };
 
+/**
+ * Identifies a part of a modifiable object, e.g. the hash of a table
+ * index.  Receivers can register for modifications of just that part.
+ * Different parts may share a key, which then only leads to spurious
+ * notifications.
+ */
+typedef uint64_t Key;
+
 /** Singleton class tracking all notification requests globally. */
 class Registry {
 public:
@@ -50,6 +58,18 @@ public:
 	 */
 	void Register(Modifiable* m, Receiver* r);
 
+	/**
+	 * Registers a receiver to be informed when a part of a modifiable
+	 * object has changed, or when the object has changed as a whole.
+	 *
+	 * @param m object to track, as with the other Register() method.
+	 *
+	 * @param key the part of the object to track.
+	 *
+	 * @param r receiver to notify on changes.
+	 */
+	void Register(Modifiable* m, Key key, Receiver* r);
+
 	/**
 	 * Cancels a receiver's request to be informed about an object's
 	 * modification. The arguments to the method must match what was
@@ -61,6 +81,19 @@ public:
 	 */
 	void Unregister(Modifiable* m, Receiver* Receiver);
 
+	/**
+	 * Cancels a receiver's request to be informed about modifications of
+	 * a part of an object.  The arguments to the method must match what
+	 * was originally registered.
+	 *
+	 * @param m object to no loger track.
+	 *
+	 * @param key the part of the object to no longer track.
+	 *
+	 * @param r receiver to no longer notify.
+	 */
+	void Unregister(Modifiable* m, Key key, Receiver* r);
+
 	/**
 	 * Cancels any active receiver requests to be informed about a
 	 * partilar object's modifications.
@@ -76,7 +109,19 @@ private:
 	// Will be called from the object itself.
 	void Modified(Modifiable* m);
 
-	typedef std::unordered_multimap<Modifiable*, Receiver*> ModifiableMap;
+	// Inform the receivers of the object as a whole and those of the
+	// given part of it about a modification of that part.
+	void Modified(Modifiable* m, Key key);
+
+	// Receivers with the number of times each one registered.
+	typedef std::unordered_map<Receiver*, int> ReceiverMap;
+
+	struct Registrations {
+		ReceiverMap all;
+		std::unordered_map<Key, ReceiverMap> keyed;
+	};
+
+	typedef std::unordered_map<Modifiable*, Registrations> ModifiableMap;
 	ModifiableMap registrations;
 };
 
@@ -101,6 +146,19 @@ public:
 			registry.Modified(this);
 		}
 
+	/**
+	 * Calling this method signals a modification of a part of the
+	 * object to all receivers registered for the object or for that
+	 * part.
+	 *
+	 * @param key the part of the object that was modified.
+	 */
+	void Modified(Key key)
+		{
+		if ( num_receivers )
+			registry.Modified(this, key);
+		}
+
 protected:
 	friend class Registry;
 
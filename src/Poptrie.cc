@@ -0,0 +1,204 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek-config.h"
+
+#include <algorithm>
+
+#include "Poptrie.h"
+
+// Number of prefixes above which the first level gets resolved through a
+// 2^16 array, as the paper suggests.  Smaller tries use 2^8 entries.
+#define POPTRIE_LARGE 4096
+
+Poptrie::Poptrie(int key_bits)
+	{
+	key_words = key_bits / 32;
+	direct_bits = 8;
+	direct.assign(1 << direct_bits, LEAF);
+	leaves.push_back(0);
+	}
+
+void Poptrie::Build(std::vector<Prefix>* prefixes, void* def)
+	{
+	direct.clear();
+	nodes.clear();
+	leaves.clear();
+
+	// Clear the bits beyond each prefix's length, so that prefixes sort
+	// in trie order and extracting bits past the end yields zeros.
+	for ( auto& p : *prefixes )
+		{
+		for ( int i = 0; i < 4; ++i )
+			{
+			int bits = std::min(std::max(p.len - 32 * i, 0), 32);
+
+			if ( i >= key_words || bits == 0 )
+				p.key[i] = 0;
+			else if ( bits < 32 )
+				p.key[i] &= ~(0xffffffffu >> bits);
+			}
+		}
+
+	std::sort(prefixes->begin(), prefixes->end(),
+		  [](const Prefix& a, const Prefix& b)
+			{
+			for ( int i = 0; i < 4; ++i )
+				if ( a.key[i] != b.key[i] )
+					return a.key[i] < b.key[i];
+
+			return a.len < b.len;
+			});
+
+	std::vector<const Prefix*> ptrs;
+	ptrs.reserve(prefixes->size());
+
+	for ( const auto& p : *prefixes )
+		{
+		if ( p.len == 0 )
+			def = p.data;
+		else
+			ptrs.push_back(&p);
+		}
+
+	direct_bits = ptrs.size() >= POPTRIE_LARGE ? 16 : 8;
+
+	std::vector<void*> best;
+	std::vector<const Prefix*> longer;
+	std::vector<size_t> offsets;
+
+	const Prefix* const* begin = ptrs.data();
+	Split(begin, begin + ptrs.size(), 0, direct_bits, def,
+	      &best, &longer, &offsets);
+
+	direct.resize(1 << direct_bits);
+
+	std::vector<uint32_t> internal;
+
+	for ( size_t i = 0; i < direct.size(); ++i )
+		{
+		if ( offsets[i] < offsets[i + 1] )
+			{
+			direct[i] = nodes.size();
+			nodes.push_back(Node());
+			internal.push_back(i);
+			}
+
+		else if ( i > 0 && (direct[i - 1] & LEAF) &&
+			  leaves.back() == best[i] )
+			direct[i] = direct[i - 1];
+
+		else
+			{
+			direct[i] = LEAF | leaves.size();
+			leaves.push_back(best[i]);
+			}
+		}
+
+	for ( auto i : internal )
+		BuildNode(direct[i], longer.data() + offsets[i],
+			  longer.data() + offsets[i + 1], direct_bits, best[i]);
+
+	nodes.shrink_to_fit();
+	leaves.shrink_to_fit();
+	}
+
+void Poptrie::Split(const Prefix* const* begin, const Prefix* const* end,
+		    int depth, int stride, void* inherited,
+		    std::vector<void*>* best,
+		    std::vector<const Prefix*>* longer,
+		    std::vector<size_t>* offsets) const
+	{
+	size_t n = size_t(1) << stride;
+	std::vector<int> best_len(n, depth);
+
+	best->assign(n, inherited);
+	longer->clear();
+	offsets->assign(n + 1, 0);
+
+	// Prefixes are nested or disjoint, so each subtree is covered by at
+	// most one prefix of each length; the longest one wins.
+	for ( const Prefix* const* p = begin; p != end; ++p )
+		{
+		uint32_t first = Extract((*p)->key, depth, stride);
+
+		if ( (*p)->len > depth + stride )
+			{
+			longer->push_back(*p);
+			++(*offsets)[first + 1];
+			continue;
+			}
+
+		uint32_t last = first + (uint32_t(1) << (depth + stride - (*p)->len));
+
+		for ( uint32_t i = first; i < last; ++i )
+			{
+			if ( (*p)->len > best_len[i] )
+				{
+				best_len[i] = (*p)->len;
+				(*best)[i] = (*p)->data;
+				}
+			}
+		}
+
+	// Sorting keeps prefixes of the same subtree together.
+	for ( size_t i = 0; i < n; ++i )
+		(*offsets)[i + 1] += (*offsets)[i];
+	}
+
+void Poptrie::BuildNode(uint32_t idx, const Prefix* const* begin,
+			const Prefix* const* end, int depth, void* inherited)
+	{
+	std::vector<void*> best;
+	std::vector<const Prefix*> longer;
+	std::vector<size_t> offsets;
+
+	Split(begin, end, depth, STRIDE, inherited, &best, &longer, &offsets);
+
+	uint64_t vector = 0;
+	uint64_t leafvec = 0;
+	uint32_t base0 = leaves.size();
+	uint32_t base1 = nodes.size();
+	bool have_leaf = false;
+
+	for ( int i = 0; i < (1 << STRIDE); ++i )
+		{
+		if ( offsets[i] < offsets[i + 1] )
+			{
+			vector |= uint64_t(1) << i;
+			continue;
+			}
+
+		if ( ! have_leaf || leaves.back() != best[i] )
+			{
+			leafvec |= uint64_t(1) << i;
+			leaves.push_back(best[i]);
+			have_leaf = true;
+			}
+		}
+
+	// The node's internal children need to be adjacent, so reserve their
+	// slots before filling in any of them.
+	nodes.resize(nodes.size() + __builtin_popcountll(vector));
+
+	nodes[idx].vector = vector;
+	nodes[idx].leafvec = leafvec;
+	nodes[idx].base0 = base0;
+	nodes[idx].base1 = base1;
+
+	uint32_t child = base1;
+
+	for ( int i = 0; i < (1 << STRIDE); ++i )
+		{
+		if ( vector & (uint64_t(1) << i) )
+			BuildNode(child++, longer.data() + offsets[i],
+				  longer.data() + offsets[i + 1],
+				  depth + STRIDE, best[i]);
+		}
+	}
+
+unsigned int Poptrie::MemoryAllocation() const
+	{
+	return sizeof(*this) + direct.capacity() * sizeof(uint32_t) +
+		nodes.capacity() * sizeof(Node) +
+		leaves.capacity() * sizeof(void*);
+	}
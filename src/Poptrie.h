@@ -0,0 +1,105 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+// A compressed multibit trie for longest-prefix matching, following Asai
+// and Ohara, "Poptrie: A Compressed Trie with Population Count for Fast
+// and Scalable Software IP Routing Table Lookup" (SIGCOMM 2015).
+//
+// A lookup resolves the key's top bits through a directly indexed array
+// and then descends 6 bits at a time through nodes whose children are
+// stored contiguously, located via a population count over a bitmap.
+// Runs of identical leaves within a node are stored only once.
+//
+// The trie is immutable: it's built in one go from a set of prefixes and
+// needs to be rebuilt from scratch to reflect changes.  Keys are arrays
+// of 32-bit words in host byte order, most significant word first.
+class Poptrie {
+public:
+	struct Prefix {
+		uint32_t key[4];
+		int len;
+		void* data;
+	};
+
+	// key_bits is the width of the keys, either 32 or 128.
+	explicit Poptrie(int key_bits);
+
+	// Builds the trie from the given prefixes, replacing any previous
+	// contents.  Only the first len bits of a prefix's key are taken into
+	// account.  Lookups of keys not covered by any prefix return def.
+	// Reorders the prefixes.
+	void Build(std::vector<Prefix>* prefixes, void* def);
+
+	// Returns the data of the longest prefix that the key falls into.
+	void* Lookup(const uint32_t* key) const
+		{
+		uint32_t d = direct[Extract(key, 0, direct_bits)];
+
+		if ( d & LEAF )
+			return leaves[d & ~LEAF];
+
+		const Node* n = &nodes[d];
+		int offset = direct_bits;
+		uint32_t v = Extract(key, offset, STRIDE);
+
+		while ( n->vector & (uint64_t(1) << v) )
+			{
+			n = &nodes[n->base1 + Rank(n->vector, v) - 1];
+			offset += STRIDE;
+			v = Extract(key, offset, STRIDE);
+			}
+
+		return leaves[n->base0 + Rank(n->leafvec, v) - 1];
+		}
+
+	unsigned int MemoryAllocation() const;
+
+private:
+	static const int STRIDE = 6;
+	static const uint32_t LEAF = 0x80000000;
+
+	struct Node {
+		uint64_t vector;	// bit i set: child i is an internal node
+		uint64_t leafvec;	// bit i set: a new run of leaves starts at i
+		uint32_t base0;		// index of the node's first leaf
+		uint32_t base1;		// index of the node's first internal child
+	};
+
+	// Returns n bits (1 <= n <= 16) of the key starting at the given bit
+	// offset.  Bits beyond the end of the key read as zero.
+	uint32_t Extract(const uint32_t* key, int offset, int n) const
+		{
+		int w = offset >> 5;
+		uint64_t x = (uint64_t(w < key_words ? key[w] : 0) << 32) |
+			     (w + 1 < key_words ? key[w + 1] : 0);
+		return uint32_t((x << (offset & 31)) >> (64 - n));
+		}
+
+	// Number of bits set in the bitmap up to and including bit i.
+	static int Rank(uint64_t bitmap, uint32_t i)
+		{ return __builtin_popcountll(bitmap & ((uint64_t(2) << i) - 1)); }
+
+	// Determines, for each of the 2^stride subtrees below depth, the data
+	// it inherits from prefixes ending within the stride, and collects
+	// the longer prefixes grouped by subtree (starting at offsets[i]).
+	void Split(const Prefix* const* begin, const Prefix* const* end,
+		   int depth, int stride, void* inherited,
+		   std::vector<void*>* best,
+		   std::vector<const Prefix*>* longer,
+		   std::vector<size_t>* offsets) const;
+
+	void BuildNode(uint32_t idx, const Prefix* const* begin,
+		       const Prefix* const* end, int depth, void* inherited);
+
+	int key_words;
+	int direct_bits;
+	std::vector<uint32_t> direct;
+	std::vector<Node> nodes;
+	std::vector<void*> leaves;
+};
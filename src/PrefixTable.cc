@@ -1,5 +1,20 @@
 #include "PrefixTable.h"
 #include "Reporter.h"
+#include "NetVar.h"
+
+PrefixTable::PrefixTable()
+	{
+	tree = New_Patricia(128);
+	v4_index = v6_index = 0;
+	lookups_since_change = 0;
+	}
+
+PrefixTable::~PrefixTable()
+	{
+	Destroy_Patricia(tree, 0);
+	delete v4_index;
+	delete v6_index;
+	}
 
 prefix_t* PrefixTable::MakePrefix(const IPAddr& addr, int width)
 	{
@@ -36,6 +51,8 @@ void* PrefixTable::Insert(const IPAddr& addr, int width, void* data)
 	// node itself.
 	node->data = data ? data : node;
 
+	InvalidateIndex();
+
 	return old;
 	}
 
@@ -87,6 +104,18 @@ list<tuple<IPPrefix,void*>> PrefixTable::FindAll(const SubNetVal* value) const
 
 void* PrefixTable::Lookup(const IPAddr& addr, int width, bool exact) const
 	{
+	if ( ! exact && width == 128 && UseIndex() )
+		{
+		const uint32_t* bytes;
+		uint32_t key[4];
+		int n = addr.GetBytes(&bytes);
+
+		for ( int i = 0; i < n; ++i )
+			key[i] = ntohl(bytes[i]);
+
+		return n == 1 ? v4_index->Lookup(key) : v6_index->Lookup(key);
+		}
+
 	prefix_t* prefix = MakePrefix(addr, width);
 	patricia_node_t* node =
 		exact ? patricia_search_exact(tree, prefix) :
@@ -134,6 +163,7 @@ void* PrefixTable::Remove(const IPAddr& addr, int width)
 
 	void* old = node->data;
 	patricia_remove(tree, node);
+	InvalidateIndex();
 
 	return old;
 	}
@@ -201,3 +231,93 @@ void* PrefixTable::GetNext(iterator* i)
 
 	// Not reached.
 	}
+
+bool PrefixTable::UseIndex() const
+	{
+	if ( v4_index )
+		return true;
+
+	int size = tree->num_active_node;
+
+	if ( prefix_table_index_min_size <= 0 ||
+	     size < prefix_table_index_min_size )
+		return false;
+
+	// Only rebuild once the lookups since the last change have paid for
+	// it, so tables that change about as often as they're queried stay
+	// with the patricia trie.
+	if ( ++lookups_since_change < size )
+		return false;
+
+	BuildIndex();
+	return true;
+	}
+
+void PrefixTable::BuildIndex() const
+	{
+	// IPv4 addresses are kept as IPv4-mapped IPv6 addresses in the
+	// patricia trie.  The IPv4 index covers that part of the address
+	// space with 32-bit keys; IPv6 prefixes enclosing all of it become
+	// its default.
+	static const uint32_t v4_mapped[4] = { 0, 0, 0xffff, 0 };
+
+	std::vector<Poptrie::Prefix> v4;
+	std::vector<Poptrie::Prefix> v6;
+	void* v4_default = 0;
+	int v4_default_len = -1;
+
+	patricia_node_t* node;
+	PATRICIA_WALK(tree->head, node)
+		{
+		Poptrie::Prefix p;
+		const uint32_t* words = reinterpret_cast<const uint32_t*>(&node->prefix->add.sin6);
+
+		for ( int i = 0; i < 4; ++i )
+			p.key[i] = ntohl(words[i]);
+
+		p.len = node->prefix->bitlen;
+		p.data = node->data;
+
+		// Does the prefix cover all IPv4-mapped addresses (len <= 96),
+		// or lie within them (len >= 96)?
+		int common = 0;
+
+		while ( common < 96 && common < p.len &&
+			! ((p.key[common / 32] ^ v4_mapped[common / 32]) &
+			   (0x80000000u >> (common % 32))) )
+			++common;
+
+		if ( common == 96 && p.len >= 96 )
+			{
+			p.key[0] = p.key[3];
+			p.len -= 96;
+			v4.push_back(p);
+			}
+
+		else
+			{
+			if ( common == p.len && p.len > v4_default_len )
+				{
+				v4_default = p.data;
+				v4_default_len = p.len;
+				}
+
+			v6.push_back(p);
+			}
+		}
+	PATRICIA_WALK_END;
+
+	v4_index = new Poptrie(32);
+	v4_index->Build(&v4, v4_default);
+
+	v6_index = new Poptrie(128);
+	v6_index->Build(&v6, 0);
+	}
+
+void PrefixTable::InvalidateIndex()
+	{
+	delete v4_index;
+	delete v6_index;
+	v4_index = v6_index = 0;
+	lookups_since_change = 0;
+	}
@@ -3,6 +3,7 @@
 #include "Val.h"
 #include "net_util.h"
 #include "IPAddr.h"
+#include "Poptrie.h"
 
 extern "C" {
 	#include "patricia.h"
@@ -18,8 +19,8 @@ private:
 	};
 
 public:
-	PrefixTable()	{ tree = New_Patricia(128); }
-	~PrefixTable()	{ Destroy_Patricia(tree, 0); }
+	PrefixTable();
+	~PrefixTable();
 
 	// Addr in network byte order. If data is zero, acts like a set.
 	// Returns ptr to old data if already existing.
@@ -43,7 +44,7 @@ public:
 	void* Remove(const IPAddr& addr, int width);
 	void* Remove(const Val* value);
 
-	void Clear()	{ Clear_Patricia(tree, 0); }
+	void Clear()	{ Clear_Patricia(tree, 0); InvalidateIndex(); }
 
 	iterator InitIterator();
 	void* GetNext(iterator* i);
@@ -52,5 +53,17 @@ private:
 	static prefix_t* MakePrefix(const IPAddr& addr, int width);
 	static IPPrefix PrefixToIPPrefix(prefix_t* p);
 
+	// Longest-prefix matches of single addresses go through a Poptrie
+	// copy of the table once it's large enough and has been queried
+	// more often than it has changed since the last rebuild.  Any change
+	// invalidates the copy; it's rebuilt in bulk on demand.
+	bool UseIndex() const;
+	void BuildIndex() const;
+	void InvalidateIndex();
+
 	patricia_tree_t* tree;
+
+	mutable Poptrie* v4_index;
+	mutable Poptrie* v6_index;
+	mutable int lookups_since_change;
 };
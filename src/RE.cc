@@ -307,8 +307,7 @@ inline void RE_Match_State::AddMatches(const AcceptingSet& as,
 		accepted_matches.insert(am_idx(*it, position));
 	}
 
-bool RE_Match_State::Match(const u_char* bv, int n,
-				bool bol, bool eol, bool clear)
+bool RE_Match_State::Start(bool clear)
 	{
 	if ( current_pos == -1 )
 		{
@@ -324,16 +323,37 @@ bool RE_Match_State::Match(const u_char* bv, int n,
 
 		if ( ac )
 			AddMatches(*ac, 0);
+
+		current_pos = 0;
 		}
 
 	else if ( clear )
 		current_state = dfa->StartState();
 
-	if ( ! current_state )
+	return current_state != 0;
+	}
+
+bool RE_Match_State::Match(const u_char* bv, int n,
+				bool bol, bool eol, bool clear)
+	{
+	if ( ! Start(clear) )
 		return false;
 
 	current_pos = 0;
+	return Feed(bv, n, bol, eol);
+	}
+
+bool RE_Match_State::MatchContinued(const u_char* bv, int n,
+				    bool bol, bool eol)
+	{
+	if ( ! Start(false) )
+		return false;
 
+	return Feed(bv, n, bol, eol);
+	}
+
+bool RE_Match_State::Feed(const u_char* bv, int n, bool bol, bool eol)
+	{
 	size_t old_matches = accepted_matches.size();
 
 	int ec;
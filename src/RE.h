@@ -156,6 +156,15 @@ public:
 	// If clear is true, starts matching over.
 	bool Match(const u_char* bv, int n, bool bol, bool eol, bool clear);
 
+	// Like Match() without clearing, but the positions of new matches
+	// continue to count from where the previous call stopped, as if all
+	// of the input had been passed in one go.
+	bool MatchContinued(const u_char* bv, int n, bool bol, bool eol);
+
+	// Returns true if no further input can lead to new matches.
+	bool Done() const
+		{ return ! dfa || (current_pos >= 0 && ! current_state); }
+
 	void Clear()
 		{
 		current_pos = -1;
@@ -166,6 +175,13 @@ public:
 	void AddMatches(const AcceptingSet& as, MatchPos position);
 
 protected:
+	// Sets up the state for the first input, or resets it if clear is
+	// true.  Returns false if no match is possible.
+	bool Start(bool clear);
+
+	// Runs the DFA over the input, starting at current_pos.
+	bool Feed(const u_char* bv, int n, bool bol, bool eol);
+
 	DFA_Machine* dfa;
 	int* ecs;
 
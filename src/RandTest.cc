@@ -13,6 +13,8 @@
 */
 
 #include <math.h>
+#include <string.h>
+
 #include "RandTest.h"
 
 #define log2of10 3.32192809488736234787
@@ -39,54 +41,156 @@ RandTest::RandTest()
 		}
 	}
 
+// Inputs are fed through add_block() in chunks of this many bytes (a
+// multiple of RT_MONTEN), small enough for the data to stay in the L1
+// cache across the passes over it.
+#define RT_CHUNK 6144
+
+// Below this, the per-byte loop is just as fast.
+#define RT_BLOCK_MIN 64
+
+// Integers up to this value add up exactly in a double.
+#define RT_EXACT_MAX 9007199254740992.0
+
 void RandTest::add(const void *buf, int bufl)
 	{
 	const unsigned char *bp = static_cast<const unsigned char*>(buf);
-	int oc;
 
-	while (bufl-- > 0)
+	// Get to the start of a Monte Carlo group, with the serial
+	// correlation seeded, so that whole groups can be handled in bulk.
+	while ( bufl > 0 && (mp != 0 || sccfirst) )
 		{
-		oc = *bp++;
-		ccount[oc]++;   /* Update counter for this bin */
-		totalc++;
-
-		/* Update inside / outside circle counts for Monte Carlo
- 		   computation of PI */
-		monte[mp++] = oc;  /* Save character for Monte Carlo */
-		if (mp >= RT_MONTEN)  /* Calculate every RT_MONTEN character */
-			{
-			mp = 0;
-			mcount++;
-			montex = 0;
-			montey = 0;
-			for (int mj=0; mj < RT_MONTEN/2; mj++)
-				{
-				montex = (montex * 256.0) + monte[mj];
-				montey = (montey * 256.0) + monte[(RT_MONTEN / 2) + mj];
-				}
-			if (montex*montex + montey*montey <= RT_INCIRC)
-				{
-				inmont++;
-				}
-			}
+		add_byte(*bp++);
+		--bufl;
+		}
+
+	while ( bufl >= RT_BLOCK_MIN )
+		{
+		int n = bufl < RT_CHUNK ? bufl : RT_CHUNK;
+		n -= n % RT_MONTEN;
+
+		// add_block() adds up the chunk's sums as integers before
+		// adding them to the accumulators. That yields the same result
+		// as adding up byte by byte only as long as the accumulators
+		// remain exact, which takes about 138GB of input to exceed.
+		if ( scct1 + 65025.0 * n > RT_EXACT_MAX ||
+		     scct3 + 65025.0 * n > RT_EXACT_MAX )
+			break;
+
+		add_block(bp, n);
+		bp += n;
+		bufl -= n;
+		}
+
+	while ( bufl-- > 0 )
+		add_byte(*bp++);
+	}
+
+void RandTest::add_byte(int oc)
+	{
+	ccount[oc]++;   /* Update counter for this bin */
+	totalc++;
 
-		/* Update calculation of serial correlation coefficient */
-		if (sccfirst)
+	/* Update inside / outside circle counts for Monte Carlo
+	   computation of PI */
+	monte[mp++] = oc;  /* Save character for Monte Carlo */
+	if (mp >= RT_MONTEN)  /* Calculate every RT_MONTEN character */
+		{
+		mp = 0;
+		mcount++;
+		montex = 0;
+		montey = 0;
+		for (int mj=0; mj < RT_MONTEN/2; mj++)
 			{
-			sccfirst = 0;
-			scclast = 0;
-			sccu0 = oc;
+			montex = (montex * 256.0) + monte[mj];
+			montey = (montey * 256.0) + monte[(RT_MONTEN / 2) + mj];
 			}
-		else
+		if (montex*montex + montey*montey <= RT_INCIRC)
 			{
-			scct1 = scct1 + scclast * oc;
+			inmont++;
 			}
+		}
+
+	/* Update calculation of serial correlation coefficient */
+	if (sccfirst)
+		{
+		sccfirst = 0;
+		scclast = 0;
+		sccu0 = oc;
+		}
+	else
+		{
+		scct1 = scct1 + scclast * oc;
+		}
+
+	scct2 = scct2 + oc;
+	scct3 = scct3 + (oc * oc);
+	scclast = oc;
+	}
+
+void RandTest::add_block(const unsigned char* bp, int n)
+	{
+	static_assert(RT_MONTEN == 6, "Monte Carlo groups need to be 2 x 3 bytes");
+
+	// Spread the histogram updates across several sets of bins, so that
+	// runs of the same byte value don't serialize on a single counter.
+	uint32_t lanes[4][256];
+	memset(lanes, 0, sizeof(lanes));
 
-		scct2 = scct2 + oc;
-		scct3 = scct3 + (oc * oc);
-		scclast = oc;
-		oc <<= 1;
+	uint32_t prev = uint32_t(scclast);
+	uint64_t sumprod = 0;
+	uint64_t inside = 0;
+	uint64_t x = 0;
+	uint64_t y = 0;
+
+	for ( int i = 0; i < n; i += RT_MONTEN )
+		{
+		uint32_t c0 = bp[i], c1 = bp[i + 1], c2 = bp[i + 2];
+		uint32_t c3 = bp[i + 3], c4 = bp[i + 4], c5 = bp[i + 5];
+
+		lanes[0][c0]++;
+		lanes[1][c1]++;
+		lanes[2][c2]++;
+		lanes[3][c3]++;
+		lanes[0][c4]++;
+		lanes[1][c5]++;
+
+		sumprod += prev * c0 + c0 * c1 + c1 * c2 + c2 * c3 + c3 * c4 + c4 * c5;
+		prev = c5;
+
+		// Integer coordinates are exact, just like the doubles that
+		// add_byte() uses.
+		x = (c0 << 16) | (c1 << 8) | c2;
+		y = (c3 << 16) | (c4 << 8) | c5;
+		inside += ( x * x + y * y <= uint64_t(RT_INCIRC) );
 		}
+
+	// The byte sums for the serial correlation follow from the
+	// histogram.
+	uint64_t sum = 0;
+	uint64_t sumsq = 0;
+
+	for ( int j = 0; j < 256; ++j )
+		{
+		uint64_t c = lanes[0][j] + lanes[1][j] + lanes[2][j] + lanes[3][j];
+		ccount[j] += c;
+		sum += j * c;
+		sumsq += j * j * c;
+		}
+
+	for ( int j = 0; j < RT_MONTEN; ++j )
+		monte[j] = bp[n - RT_MONTEN + j];
+
+	totalc += n;
+	mcount += n / RT_MONTEN;
+	inmont += inside;
+	montex = x;
+	montey = y;
+
+	scct1 = scct1 + sumprod;
+	scct2 = scct2 + sum;
+	scct3 = scct3 + sumsq;
+	scclast = bp[n - 1];
 	}
 
 void RandTest::end(double* r_ent, double* r_chisq,
@@ -19,6 +19,11 @@ class RandTest {
 	private:
 	  friend class EntropyVal;
 
+		void add_byte(int oc);
+		// Processes n bytes at the start of a Monte Carlo group, with n
+		// a multiple of RT_MONTEN.
+		void add_block(const unsigned char* bp, int n);
+
 		int64_t ccount[256];  /* Bins to count occurrences of values */
 		int64_t totalc;       /* Total bytes counted */
 		int mp;
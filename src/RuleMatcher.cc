@@ -673,7 +673,49 @@ RuleMatcher::MIME_Matches* RuleMatcher::Match(RuleFileMagicState* state,
 		return rval;
 
 	DBG_LOG(DBG_RULES, "New pattern match found");
+	CollectMIMEMatches(state, rval);
+	return rval;
+	}
+
+bool RuleMatcher::MatchIncremental(RuleFileMagicState* state,
+                                   const u_char* data, uint64_t len,
+                                   MIME_Matches* rval) const
+	{
+	if ( ! state )
+		{
+		reporter->Warning("RuleFileMagicState not initialized yet.");
+		return false;
+		}
+
+	bool newmatch = false;
+	bool more = false;
+
+	for ( const auto& m : state->matchers )
+		{
+		if ( m->state->Done() )
+			continue;
+
+		bool bol = m->state->Length() < 0;
+
+		if ( m->state->MatchContinued(data, len, bol, false) )
+			newmatch = true;
+
+		if ( ! m->state->Done() )
+			more = true;
+		}
+
+	if ( newmatch )
+		{
+		DBG_LOG(DBG_RULES, "New pattern match found");
+		CollectMIMEMatches(state, rval);
+		}
+
+	return more;
+	}
 
+void RuleMatcher::CollectMIMEMatches(RuleFileMagicState* state,
+                                     MIME_Matches* rval) const
+	{
 	AcceptingMatchSet accepted_matches;
 
 	for ( const auto& m : state->matchers )
@@ -714,8 +756,6 @@ RuleMatcher::MIME_Matches* RuleMatcher::Match(RuleFileMagicState* state,
 			ss.insert(ram->GetMIME());
 			}
 		}
-
-	return rval;
 	}
 
 RuleEndpointState* RuleMatcher::InitEndpoint(analyzer::Analyzer* analyzer,
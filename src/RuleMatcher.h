@@ -252,6 +252,21 @@ public:
 	MIME_Matches* Match(RuleFileMagicState* state, const u_char* data,
 	                   uint64_t len, MIME_Matches* matches = 0) const;
 
+	/**
+	 * Matches the next chunk of a file against file magic signatures,
+	 * continuing where the previous call for the same state stopped.
+	 * The results are the same as if all chunks had been passed to
+	 * Match() at once.
+	 * @param state A state object previously returned from
+	 *              RuleMatcher::InitFileMagic()
+	 * @param data Chunk of data to match signatures against.
+	 * @param len Length of \a data in bytes.
+	 * @param matches A match result object to update with new matches.
+	 * @return false if no further data can lead to additional matches,
+	 *         in which case matching may stop early.
+	 */
+	bool MatchIncremental(RuleFileMagicState* state, const u_char* data,
+	                      uint64_t len, MIME_Matches* matches) const;
 
 	/**
 	 * Resets a state object used with matching file magic signatures.
@@ -314,6 +329,11 @@ private:
 	// Delete node and all children.
 	void Delete(RuleHdrTest* node);
 
+	// Adds the MIME types of all file magic rules whose patterns have
+	// matched so far.
+	void CollectMIMEMatches(RuleFileMagicState* state,
+	                        MIME_Matches* matches) const;
+
 	// Build tree containing all added rules.
 	void BuildRulesTree();
 
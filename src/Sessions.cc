@@ -104,6 +104,8 @@ NetSessions::NetSessions()
 
 	dump_this_packet = 0;
 	num_packets_processed = 0;
+	num_bypassed_packets = 0;
+	num_bypassed_bytes = 0;
 
 	if ( pkt_profile_mode && pkt_profile_freq > 0 && pkt_profile_file )
 		pkt_profiler = new PacketProfiler(pkt_profile_mode,
@@ -756,6 +758,14 @@ void NetSessions::DoNextPacket(double t, const Packet* pkt, const IP_Hdr* ip_hdr
 	if ( ! conn )
 		return;
 
+	if ( conn->Bypassed() )
+		{
+		conn->BypassedPacket(t, ip_hdr->TotalLen());
+		++num_bypassed_packets;
+		num_bypassed_bytes += ip_hdr->TotalLen();
+		return;
+		}
+
 	int record_packet = 1;	// whether to record the packet at all
 	int record_content = 1;	// whether to record its data
 
@@ -1170,6 +1180,8 @@ void NetSessions::GetStats(SessionStats& s) const
 	s.cumulative_ICMP_conns = stats.cumulative_ICMP_conns;
 	s.num_fragments = fragments.size();
 	s.num_packets = num_packets_processed;
+	s.num_bypassed_packets = num_bypassed_packets;
+	s.num_bypassed_bytes = num_bypassed_bytes;
 
 	s.max_TCP_conns = stats.max_TCP_conns;
 	s.max_UDP_conns = stats.max_UDP_conns;
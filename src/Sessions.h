@@ -42,6 +42,9 @@ struct SessionStats {
 	size_t num_fragments;
 	size_t max_fragments;
 	uint64_t num_packets;
+
+	uint64_t num_bypassed_packets;
+	uint64_t num_bypassed_bytes;
 };
 
 // Drains and deletes a timer manager if it hasn't seen any advances
@@ -242,6 +245,8 @@ protected:
 	PacketFilter* packet_filter;
 	int dump_this_packet;	// if true, current packet should be recorded
 	uint64_t num_packets_processed;
+	uint64_t num_bypassed_packets;
+	uint64_t num_bypassed_bytes;
 	PacketProfiler* pkt_profiler;
 
 	// We may use independent timer managers for different sets of related
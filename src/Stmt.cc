@@ -2,6 +2,8 @@
 
 #include "zeek-config.h"
 
+#include <unordered_set>
+
 #include "Expr.h"
 #include "Event.h"
 #include "Frame.h"
@@ -1743,6 +1745,33 @@ TraversalCode NullStmt::Traverse(TraversalCallback* cb) const
 	HANDLE_TC_STMT_POST(tc);
 	}
 
+// Collects the local IDs that a "when" statement refers to, so that its
+// trigger captures only those out of the enclosing frame.
+class WhenCaptureFinder : public TraversalCallback {
+public:
+	WhenCaptureFinder(id_list* arg_captures) : captures(arg_captures)	{ }
+
+	TraversalCode PreExpr(const Expr* expr) override
+		{
+		if ( expr->Tag() != EXPR_NAME )
+			return TC_CONTINUE;
+
+		ID* id = static_cast<const NameExpr*>(expr)->Id();
+
+		if ( ! id->IsGlobal() && seen.insert(id).second )
+			{
+			::Ref(id);
+			captures->append(id);
+			}
+
+		return TC_CONTINUE;
+		}
+
+private:
+	id_list* captures;
+	std::unordered_set<const ID*> seen;
+};
+
 WhenStmt::WhenStmt(Expr* arg_cond, Stmt* arg_s1, Stmt* arg_s2,
 			Expr* arg_timeout, bool arg_is_return)
 : Stmt(STMT_WHEN)
@@ -1768,6 +1797,12 @@ WhenStmt::WhenStmt(Expr* arg_cond, Stmt* arg_s1, Stmt* arg_s2,
 		if ( bt != TYPE_TIME && bt != TYPE_INTERVAL )
 			cond->Error("when timeout requires a time or time interval");
 		}
+
+	WhenCaptureFinder cb(&captures);
+	Traverse(&cb);
+
+	if ( timeout )
+		timeout->Traverse(&cb);
 	}
 
 WhenStmt::~WhenStmt()
@@ -1775,6 +1810,9 @@ WhenStmt::~WhenStmt()
 	Unref(cond);
 	Unref(s1);
 	Unref(s2);
+
+	for ( auto& id : captures )
+		Unref(id);
 	}
 
 Val* WhenStmt::Exec(Frame* f, stmt_flow_type& flow) const
@@ -1790,7 +1828,7 @@ Val* WhenStmt::Exec(Frame* f, stmt_flow_type& flow) const
 		::Ref(timeout);
 
 	// The new trigger object will take care of its own deletion.
-	new Trigger(cond, s1, s2, timeout, f, is_return, location);
+	new Trigger(cond, s1, s2, timeout, f, captures, is_return, location);
 
 	return 0;
 	}
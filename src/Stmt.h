@@ -481,6 +481,9 @@ public:
 	const Expr* TimeoutExpr() const	{ return timeout; }
 	const Stmt* TimeoutBody() const	{ return s2; }
 
+	// The local IDs that the statement refers to.
+	const id_list& Captures() const	{ return captures; }
+
 	void Describe(ODesc* d) const override;
 
 	TraversalCode Traverse(TraversalCallback* cb) const override;
@@ -493,4 +496,5 @@ protected:
 	Stmt* s2;
 	Expr* timeout;
 	bool is_return;
+	id_list captures;
 };
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <unordered_set>
 
 #include "Trigger.h"
 #include "Traverse.h"
@@ -17,9 +18,45 @@ public:
 	virtual TraversalCode PreExpr(const Expr*);
 
 private:
+	void RegisterTableKey(const Expr* table, const Expr* index);
+
 	Trigger* trigger;
+
+	// Names of tables registered for just the accessed key.
+	std::unordered_set<const Expr*> keyed_tables;
 };
 
+void TriggerTraversalCallback::RegisterTableKey(const Expr* table_expr,
+                                                const Expr* index_expr)
+	{
+	// A global table that the condition indexes only needs to be watched
+	// for modifications of that index rather than as a whole.  Tables
+	// indexed by subnets match more than just the exact index.
+	if ( table_expr->Tag() != EXPR_NAME )
+		return;
+
+	const NameExpr* ne = static_cast<const NameExpr*>(table_expr);
+	Val* v = ne->Id()->ID_Val();
+
+	if ( ! v || v->Type()->Tag() != TYPE_TABLE || v->AsTableVal()->Subnets() )
+		return;
+
+	Val* index = index_expr->Eval(trigger->frame);
+
+	if ( ! index )
+		return;
+
+	HashKey* k = v->AsTableVal()->ComputeHash(index);
+	Unref(index);
+
+	if ( ! k )
+		return;
+
+	trigger->Register(v, k->Hash());
+	keyed_tables.insert(ne);
+	delete k;
+	}
+
 TraversalCode TriggerTraversalCallback::PreExpr(const Expr* expr)
 	{
 	// We catch all expressions here which in some way reference global
@@ -32,12 +69,30 @@ TraversalCode TriggerTraversalCallback::PreExpr(const Expr* expr)
 		if ( e->Id()->IsGlobal() )
 			trigger->Register(e->Id());
 
+		if ( keyed_tables.find(e) != keyed_tables.end() )
+			break;
+
 		Val* v = e->Id()->ID_Val();
 		if ( v && v->Modifiable() )
 			trigger->Register(v);
 		break;
 		};
 
+	case EXPR_IN:
+		{
+		const BinaryExpr* e = static_cast<const BinaryExpr*>(expr);
+		BroObj::SuppressErrors no_errors;
+
+		try
+			{
+			RegisterTableKey(e->Op2(), e->Op1());
+			}
+		catch ( InterpreterException& )
+			{ /* Already reported */ }
+
+		break;
+		}
+
 	case EXPR_INDEX:
 		{
 		const IndexExpr* e = static_cast<const IndexExpr*>(expr);
@@ -45,6 +100,8 @@ TraversalCode TriggerTraversalCallback::PreExpr(const Expr* expr)
 
 		try
 			{
+			RegisterTableKey(e->Op1(), e->Op2());
+
 			Val* v = e->Eval(trigger->frame);
 
 			if ( v )
@@ -104,7 +161,8 @@ protected:
 
 Trigger::Trigger(Expr* arg_cond, Stmt* arg_body, Stmt* arg_timeout_stmts,
 			Expr* arg_timeout, Frame* arg_frame,
-			bool arg_is_return, const Location* arg_location)
+			const id_list& arg_captures, bool arg_is_return,
+			const Location* arg_location)
 	{
 	if ( ! pending )
 		pending = new list<Trigger*>;
@@ -113,10 +171,16 @@ Trigger::Trigger(Expr* arg_cond, Stmt* arg_body, Stmt* arg_timeout_stmts,
 	body = arg_body;
 	timeout_stmts = arg_timeout_stmts;
 	timeout = arg_timeout;
-	frame = arg_frame->Clone();
+	captures = arg_captures;
+
+	for ( auto& id : captures )
+		::Ref(id);
+
+	frame = arg_frame->Capture(captures);
 	timer = 0;
 	delayed = false;
 	disabled = false;
+	queued = false;
 	attached = 0;
 	is_return = arg_is_return;
 	location = arg_location;
@@ -181,6 +245,9 @@ Trigger::~Trigger()
 	Unref(frame);
 	UnregisterAll();
 
+	for ( auto& id : captures )
+		Unref(id);
+
 	Unref(attached);
 	// Due to ref'counting, "this" cannot be part of pending at this
 	// point.
@@ -211,29 +278,10 @@ bool Trigger::Eval()
 		return false;
 		}
 
-	// It's unfortunate that we have to copy the frame again here but
-	// otherwise changes to any of the locals would propagate to later
-	// evaluations.
-	//
-	// An alternative approach to copying the frame would be to deep-copy
-	// the expression itself, replacing all references to locals with
-	// constants.
-
-	Frame* f = nullptr;
-
-	try
-		{
-		f = frame->Clone();
-		}
-	catch ( InterpreterException& )
-		{
-		// Frame contains values that couldn't be cloned. It's
-		// already been reported, disable trigger.
-		Disable();
-		Unref(this);
-		return false;
-		}
-
+	// Evaluate in a fresh capture of the frame so that assignments to
+	// locals don't propagate to later evaluations.  This only takes a
+	// reference to each captured value, it doesn't copy them.
+	Frame* f = frame->Capture(captures);
 	f->SetTrigger(this);
 
 	Val* v = nullptr;
@@ -313,9 +361,10 @@ void Trigger::QueueTrigger(Trigger* trigger)
 	{
 	assert(! trigger->disabled);
 	assert(pending);
-	if ( std::find(pending->begin(), pending->end(), trigger) == pending->end() )
+	if ( ! trigger->queued )
 		{
 		Ref(trigger);
+		trigger->queued = true;
 		pending->push_back(trigger);
 		}
 	}
@@ -338,7 +387,8 @@ void Trigger::EvaluatePending()
 	for ( TriggerList::iterator i = orig->begin(); i != orig->end(); ++i )
 		{
 		Trigger* t = *i;
-		(*i)->Eval();
+		t->queued = false;
+		t->Eval();
 		Unref(t);
 		}
 
@@ -359,7 +409,7 @@ void Trigger::Timeout()
 	if ( timeout_stmts )
 		{
 		stmt_flow_type flow;
-		Frame* f = frame->Clone();
+		Frame* f = frame->Capture(captures);
 		Val* v = 0;
 
 		try
@@ -400,7 +450,7 @@ void Trigger::Register(ID* id)
 	notifier::registry.Register(id, this);
 
 	Ref(id);
-	objs.push_back({id, id});
+	objs.push_back({id, id, false, 0});
 	}
 
 void Trigger::Register(Val* val)
@@ -412,7 +462,19 @@ void Trigger::Register(Val* val)
 	notifier::registry.Register(val->Modifiable(), this);
 
 	Ref(val);
-	objs.emplace_back(val, val->Modifiable());
+	objs.push_back({val, val->Modifiable(), false, 0});
+	}
+
+void Trigger::Register(Val* val, notifier::Key key)
+	{
+	if ( ! val->Modifiable() )
+		return;
+
+	assert(! disabled);
+	notifier::registry.Register(val->Modifiable(), key, this);
+
+	Ref(val);
+	objs.push_back({val, val->Modifiable(), true, key});
 	}
 
 void Trigger::UnregisterAll()
@@ -421,8 +483,12 @@ void Trigger::UnregisterAll()
 
 	for ( const auto& o : objs )
 		{
-		notifier::registry.Unregister(o.second, this);
-		Unref(o.first);
+		if ( o.keyed )
+			notifier::registry.Unregister(o.modifiable, o.key, this);
+		else
+			notifier::registry.Unregister(o.modifiable, this);
+
+		Unref(o.obj);
 		}
 
 	objs.clear();
@@ -18,8 +18,12 @@ public:
 	// instantiation.  Note that if the condition is already true, the
 	// statements are executed immediately and the object is deleted
 	// right away.
+	//
+	// The trigger captures the values of the locals in *captures* from
+	// *f* by reference instead of copying the whole frame.
 	Trigger(Expr* cond, Stmt* body, Stmt* timeout_stmts, Expr* timeout,
-		Frame* f, bool is_return, const Location* loc);
+		Frame* f, const id_list& captures, bool is_return,
+		const Location* loc);
 	~Trigger() override;
 
 	// Evaluates the condition. If true, executes the body and deletes
@@ -84,6 +88,7 @@ private:
 	void Init();
 	void Register(ID* id);
 	void Register(Val* val);
+	void Register(Val* val, notifier::Key key);
 	void UnregisterAll();
 
 	Expr* cond;
@@ -92,6 +97,7 @@ private:
 	Expr* timeout;
 	double timeout_value;
 	Frame* frame;
+	id_list captures;
 	bool is_return;
 	const Location* location;
 
@@ -100,8 +106,17 @@ private:
 
 	bool delayed; // true if a function call is currently being delayed
 	bool disabled;
+	bool queued; // true while on the list of pending triggers
+
+	// An object we're registered for, or for a part of if keyed.
+	struct Registration {
+		BroObj* obj;
+		notifier::Modifiable* modifiable;
+		bool keyed;
+		notifier::Key key;
+	};
 
-	std::vector<std::pair<BroObj *, notifier::Modifiable*>> objs;
+	std::vector<Registration> objs;
 
 	typedef map<const CallExpr*, Val*> ValCache;
 	ValCache cache;
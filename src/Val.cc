@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <ctype.h>
+#include <algorithm>
 
 #include "Val.h"
 #include "Net.h"
@@ -29,6 +31,7 @@
 
 #include "3rdparty/json.hpp"
 #include "3rdparty/tsl-ordered-map/ordered_map.h"
+#include "3rdparty/doctest.h"
 
 
 // Define a class for use with the json library that orders the keys in the same order that
@@ -1294,6 +1297,8 @@ void TableValTimer::Dispatch(double t, int is_expire)
 		}
 	}
 
+TableVal::ExpireStats TableVal::expire_stats;
+
 static void table_entry_val_delete_func(void* val)
 	{
 	TableEntryVal* tv = (TableEntryVal*) val;
@@ -1313,7 +1318,6 @@ void TableVal::Init(TableType* t)
 	table_type = t;
 	expire_func = 0;
 	expire_time = 0;
-	expire_cookie = 0;
 	timer = 0;
 	def_val = 0;
 
@@ -1334,6 +1338,7 @@ TableVal::~TableVal()
 
 	Unref(table_type);
 	delete table_hash;
+	ExpireIndexClear();
 	delete AsTable();
 	delete subnets;
 	Unref(attrs);
@@ -1345,6 +1350,7 @@ TableVal::~TableVal()
 void TableVal::RemoveAll()
 	{
 	// Here we take the brute force approach.
+	ExpireIndexClear();
 	delete AsTable();
 	val.table_val = new PDict<TableEntryVal>;
 	val.table_val->SetDeleteFunc(table_entry_val_delete_func);
@@ -1417,6 +1423,8 @@ void TableVal::CheckExpireAttr(attr_tag at)
 		// we set a timer which fires immediately.
 		timer = new TableValTimer(this, 1);
 		timer_mgr->Add(timer);
+
+		ExpireIndexBuild();
 		}
 	}
 
@@ -1466,13 +1474,28 @@ int TableVal::Assign(Val* index, HashKey* k, Val* new_val)
 	if ( old_entry_val && attrs && attrs->FindAttr(ATTR_EXPIRE_CREATE) )
 		new_entry_val->SetExpireAccess(old_entry_val->ExpireAccessTime());
 
+	if ( old_entry_val && old_entry_val->expire_node )
+		{
+		// The new entry takes over the old one's place in the
+		// expiration index; the key it refers to stays the same.
+		TableExpireNode* n = old_entry_val->expire_node;
+		old_entry_val->expire_node = 0;
+		n->entry = new_entry_val;
+		new_entry_val->expire_node = n;
+		ExpireIndexRefile(new_entry_val);
+		}
+
+	else if ( ExpirationEnabled() )
+		ExpireIndexInsert(new_entry_val, k_copy.Key(), k_copy.Size(),
+					k_copy.Hash());
+
 	if ( old_entry_val )
 		{
 		old_entry_val->Unref();
 		delete old_entry_val;
 		}
 
-	Modified();
+	Modified(k_copy.Hash());
 	return 1;
 	}
 
@@ -1803,7 +1826,7 @@ Val* TableVal::Lookup(Val* index, bool use_default_val)
 		if ( v )
 			{
 			if ( attrs && attrs->FindAttr(ATTR_EXPIRE_READ) )
-					v->SetExpireAccess(network_time);
+					SetExpireAccess(v, network_time);
 
 			return v->Value() ? v->Value() : this;
 			}
@@ -1821,20 +1844,36 @@ Val* TableVal::Lookup(Val* index, bool use_default_val)
 
 	if ( tbl->Length() > 0 )
 		{
-		HashKey* k = ComputeHash(index);
-		if ( k )
-			{
-			TableEntryVal* v = AsTable()->Lookup(k);
-			delete k;
+		TableEntryVal* v = 0;
 
-			if ( v )
+		if ( table_hash->IsAtomic() )
+			{
+			if ( index->Type()->Tag() == TYPE_LIST )
 				{
-				if ( attrs && attrs->FindAttr(ATTR_EXPIRE_READ) )
-					v->SetExpireAccess(network_time);
+				const val_list* vl = index->AsListVal()->Vals();
+				v = LookupEntry(vl->begin(), vl->length());
+				}
+			else
+				v = LookupEntry(&index, 1);
+			}
 
-				return v->Value() ? v->Value() : this;
+		else
+			{
+			HashKey* k = ComputeHash(index);
+			if ( k )
+				{
+				v = AsTable()->Lookup(k);
+				delete k;
 				}
 			}
+
+		if ( v )
+			{
+			if ( attrs && attrs->FindAttr(ATTR_EXPIRE_READ) )
+				SetExpireAccess(v, network_time);
+
+			return v->Value() ? v->Value() : this;
+			}
 		}
 
 	if ( ! use_default_val )
@@ -1846,6 +1885,51 @@ Val* TableVal::Lookup(Val* index, bool use_default_val)
 	return def;
 	}
 
+Val* TableVal::Lookup(Val* const* index_vals, int n, bool use_default_val)
+	{
+	if ( ! subnets && table_hash->IsAtomic() )
+		{
+		TableEntryVal* v = 0;
+
+		if ( AsTable()->Length() > 0 )
+			v = LookupEntry(index_vals, n);
+
+		if ( v )
+			{
+			if ( attrs && attrs->FindAttr(ATTR_EXPIRE_READ) )
+				SetExpireAccess(v, network_time);
+
+			return v->Value() ? v->Value() : this;
+			}
+
+		if ( ! use_default_val )
+			return 0;
+		}
+
+	// Everything else needs the index as a ListVal.
+	ListVal* lv = new ListVal(TYPE_ANY);
+
+	for ( int i = 0; i < n; ++i )
+		lv->Append(index_vals[i]->Ref());
+
+	Val* v = Lookup(lv, use_default_val);
+	Unref(lv);
+	return v;
+	}
+
+TableEntryVal* TableVal::LookupEntry(const Val* const* index_vals, int n) const
+	{
+	const void* key;
+	int key_size;
+	hash_t hash;
+
+	if ( ! table_hash->ComputeTransientHash(index_vals, n, 1, key,
+						key_size, hash) )
+		return 0;
+
+	return AsTable()->Lookup(key, key_size, hash);
+	}
+
 VectorVal* TableVal::LookupSubnets(const SubNetVal* search)
 	{
 	if ( ! subnets )
@@ -1884,7 +1968,7 @@ TableVal* TableVal::LookupSubnetValues(const SubNetVal* search)
 		if ( entry )
 			{
 			if ( attrs && attrs->FindAttr(ATTR_EXPIRE_READ) )
-				entry->SetExpireAccess(network_time);
+				SetExpireAccess(entry, network_time);
 			}
 
 		Unref(s); // assign does not consume index
@@ -1913,7 +1997,7 @@ bool TableVal::UpdateTimestamp(Val* index)
 	if ( ! v )
 		return false;
 
-	v->SetExpireAccess(network_time);
+	SetExpireAccess(v, network_time);
 
 	return true;
 	}
@@ -1932,10 +2016,16 @@ Val* TableVal::Delete(const Val* index)
 	if ( subnets && ! subnets->Remove(index) )
 		reporter->InternalWarning("index not in prefix table");
 
+	if ( v )
+		ExpireIndexRemove(v);
+
+	if ( k )
+		Modified(k->Hash());
+	else
+		Modified();
+
 	delete k;
 	delete v;
-
-	Modified();
 	return va;
 	}
 
@@ -1952,9 +2042,12 @@ Val* TableVal::Delete(const HashKey* k)
 		Unref(index);
 		}
 
+	if ( v )
+		ExpireIndexRemove(v);
+
 	delete v;
 
-	Modified();
+	Modified(k->Hash());
 	return va;
 	}
 
@@ -2178,87 +2271,237 @@ void TableVal::DoExpire(double t)
 		// error, it has been reported already.
 		return;
 
-	if ( ! expire_cookie )
-		{
-		expire_cookie = tbl->InitForIteration();
-		tbl->MakeRobustCookie(expire_cookie);
-		}
+	// Entries are filed by their expiration-relevant access time, so we
+	// only need to look at the buckets at the front that are due.
+	size_t budget = table_incremental_step > 0 ? table_incremental_step : 1;
+	std::vector<std::pair<int64_t, HashKey*>> due;
+	bool done = true;
 
-	HashKey* k = 0;
-	TableEntryVal* v = 0;
-	TableEntryVal* v_saved = 0;
-	bool modified = false;
-
-	for ( int i = 0; i < table_incremental_step &&
-			 (v = tbl->NextEntry(k, expire_cookie)); ++i )
+	for ( const auto& b : expire_buckets )
 		{
-		if ( v->ExpireAccessTime() == 0 )
-			{
+		if ( bro_start_network_time + b.first == 0 )
 			// This happens when we insert val while network_time
 			// hasn't been initialized yet (e.g. in zeek_init()), and
 			// also when bro_start_network_time hasn't been initialized
 			// (e.g. before first packet).  The expire_access_time is
 			// correct, so we just need to wait.
-			}
+			continue;
+
+		if ( bro_start_network_time + b.first + timeout >= t )
+			// Neither this bucket nor any later one is due yet.
+			break;
 
-		else if ( v->ExpireAccessTime() + timeout < t )
+		for ( TableExpireNode* n = b.second.head; n; n = n->next )
 			{
-			if ( expire_func )
+			if ( due.size() >= budget )
 				{
-				Val* idx = RecoverIndex(k);
-				double secs = CallExpireFunc(idx);
-
-				// It's possible that the user-provided
-				// function modified or deleted the table
-				// value, so look it up again.
-				v_saved = v;
-				v = tbl->Lookup(k);
-
-				if ( ! v )
-					{ // user-provided function deleted it
-					v = v_saved;
-					delete k;
-					continue;
-					}
+				done = false;
+				break;
+				}
 
-				if ( secs > 0 )
-					{
-					// User doesn't want us to expire
-					// this now.
-					v->SetExpireAccess(network_time - timeout + secs);
-					delete k;
-					continue;
-					}
+			int64_t pos = tbl->IterationPosition(n->key, n->key_size,
+								n->hash);
+			due.emplace_back(pos, new HashKey(n->key, n->key_size,
+							n->hash));
+			}
 
-				}
+		if ( ! done )
+			break;
+		}
 
-			if ( subnets )
-				{
-				Val* index = RecoverIndex(k);
-				if ( ! subnets->Remove(index) )
-					reporter->InternalWarning("index not in prefix table");
-				Unref(index);
-				}
+	// Work through the entries in the order a scan of the table would
+	// visit them, which is the order &expire_func has always seen them.
+	// We hold on to copies of the keys only, as the function may change
+	// the table arbitrarily.
+	std::sort(due.begin(), due.end(),
+		  [](const std::pair<int64_t, HashKey*>& a,
+		     const std::pair<int64_t, HashKey*>& b)
+			{ return a.first < b.first; });
+
+	bool modified = false;
 
-			tbl->RemoveEntry(k);
-			Unref(v->Value());
-			delete v;
+	for ( const auto& d : due )
+		{
+		if ( ExpireEntry(d.second, t, timeout) )
 			modified = true;
-			}
 
-		delete k;
+		delete d.second;
 		}
 
+	++expire_stats.rounds;
+	expire_stats.examined += due.size();
+
+	if ( due.size() > expire_stats.max_examined )
+		expire_stats.max_examined = due.size();
+
+	if ( ! done )
+		++expire_stats.incomplete;
+
 	if ( modified )
 		Modified();
 
-	if ( ! v )
+	InitTimer(done ? table_expire_interval : table_expire_delay);
+	}
+
+bool TableVal::ExpireEntry(const HashKey* k, double t, double timeout)
+	{
+	PDict<TableEntryVal>* tbl = AsNonConstTable();
+	TableEntryVal* v = tbl->Lookup(k);
+
+	if ( ! v || v->ExpireAccessTime() + timeout >= t )
+		// Removed or refreshed by an earlier &expire_func call.
+		return false;
+
+	if ( expire_func )
+		{
+		Val* idx = RecoverIndex(k);
+		double secs = CallExpireFunc(idx);
+
+		// It's possible that the user-provided function modified or
+		// deleted the table value, so look it up again.
+		v = tbl->Lookup(k);
+
+		if ( ! v )
+			// User-provided function deleted it.
+			return false;
+
+		if ( secs > 0 )
+			{
+			// User doesn't want us to expire this now.
+			SetExpireAccess(v, network_time - timeout + secs);
+			++expire_stats.postponed;
+			return false;
+			}
+		}
+
+	if ( subnets )
+		{
+		Val* index = RecoverIndex(k);
+		if ( ! subnets->Remove(index) )
+			reporter->InternalWarning("index not in prefix table");
+		Unref(index);
+		}
+
+	double lag = t - (v->ExpireAccessTime() + timeout);
+
+	if ( lag > 0 )
+		{
+		expire_stats.total_lag += lag;
+
+		if ( lag > expire_stats.max_lag )
+			expire_stats.max_lag = lag;
+		}
+
+	++expire_stats.expired;
+
+	tbl->RemoveEntry(k);
+	ExpireIndexRemove(v);
+	Unref(v->Value());
+	delete v;
+
+	return true;
+	}
+
+void TableVal::ExpireIndexInsert(TableEntryVal* v, const void* key,
+					int key_size, hash_t hash)
+	{
+	const void* dict_key = AsTable()->LookupKey(key, key_size, hash);
+
+	if ( ! dict_key )
+		return;
+
+	TableExpireNode* n = new TableExpireNode;
+	n->entry = v;
+	n->key = dict_key;
+	n->key_size = key_size;
+	n->hash = hash;
+	n->bucket = v->expire_access_time;
+
+	v->expire_node = n;
+	ExpireIndexLink(n);
+	}
+
+void TableVal::ExpireIndexRemove(TableEntryVal* v)
+	{
+	if ( ! v->expire_node )
+		return;
+
+	ExpireIndexUnlink(v->expire_node);
+	delete v->expire_node;
+	v->expire_node = 0;
+	}
+
+void TableVal::ExpireIndexBuild()
+	{
+	const PDict<TableEntryVal>* tbl = AsTable();
+	IterCookie* c = tbl->InitForIteration();
+
+	HashKey* k;
+	TableEntryVal* v;
+	while ( (v = tbl->NextEntry(k, c)) )
+		{
+		if ( ! v->expire_node )
+			ExpireIndexInsert(v, k->Key(), k->Size(), k->Hash());
+
+		delete k;
+		}
+	}
+
+void TableVal::ExpireIndexClear()
+	{
+	for ( const auto& b : expire_buckets )
+		{
+		TableExpireNode* n = b.second.head;
+
+		while ( n )
+			{
+			TableExpireNode* next = n->next;
+			n->entry->expire_node = 0;
+			delete n;
+			n = next;
+			}
+		}
+
+	expire_buckets.clear();
+	}
+
+void TableVal::ExpireIndexLink(TableExpireNode* n)
+	{
+	// Append, so that each bucket lists its entries in access order.
+	auto it = expire_buckets.find(n->bucket);
+
+	n->next = 0;
+
+	if ( it == expire_buckets.end() )
 		{
-		expire_cookie = 0;
-		InitTimer(table_expire_interval);
+		n->prev = 0;
+		expire_buckets[n->bucket] = {n, n};
+		return;
 		}
+
+	n->prev = it->second.tail;
+	it->second.tail->next = n;
+	it->second.tail = n;
+	}
+
+void TableVal::ExpireIndexUnlink(TableExpireNode* n)
+	{
+	auto it = expire_buckets.find(n->bucket);
+
+	if ( n->prev )
+		n->prev->next = n->next;
+	else
+		it->second.head = n->next;
+
+	if ( n->next )
+		n->next->prev = n->prev;
 	else
-		InitTimer(table_expire_delay);
+		it->second.tail = n->prev;
+
+	if ( ! it->second.head )
+		expire_buckets.erase(it);
+
+	n->prev = n->next = 0;
 	}
 
 double TableVal::GetExpireTime()
@@ -2410,8 +2653,9 @@ Val* TableVal::DoClone(CloneState* state)
 
 		// As network_time is not necessarily initialized yet, we set
 		// a timer which fires immediately.
-		timer = new TableValTimer(this, 1);
-		timer_mgr->Add(timer);
+		tv->timer = new TableValTimer(tv, 1);
+		timer_mgr->Add(tv->timer);
+		tv->ExpireIndexBuild();
 		}
 
 	if ( expire_func )
@@ -3186,6 +3430,7 @@ bool can_cast_value_to_type(const BroType* s, BroType* t)
 ValManager::ValManager()
 	{
 	empty_string = new StringVal("");
+	interned_strings = new PDict<StringVal>;
 	b_false = Val::MakeBool(false);
 	b_true = Val::MakeBool(true);
 	counts = new Val*[PREALLOCATED_COUNTS];
@@ -3225,6 +3470,14 @@ ValManager::~ValManager()
 	for ( auto& arr : ports )
 		for ( auto& pv : arr )
 			Unref(pv);
+
+	IterCookie* c = interned_strings->InitForIteration();
+	StringVal* sv;
+
+	while ( (sv = interned_strings->NextEntry(c)) )
+		Unref(sv);
+
+	delete interned_strings;
 	}
 
 StringVal* ValManager::GetEmptyString() const
@@ -3233,6 +3486,101 @@ StringVal* ValManager::GetEmptyString() const
 	return empty_string;
 	}
 
+void ValManager::InternString(const char* s)
+	{
+	int len = strlen(s);
+
+	if ( len > MAX_INTERNED_STRING_LENGTH )
+		reporter->InternalError("string too long for intern pool: %s", s);
+
+	HashKey k(s, len);
+
+	if ( interned_strings->Lookup(&k) )
+		return;
+
+	interned_strings->Insert(&k, new StringVal(len, s));
+	}
+
+StringVal* ValManager::GetInternedString(int len, const char* s)
+	{
+	if ( len <= MAX_INTERNED_STRING_LENGTH )
+		{
+		hash_t h = HashKey::HashBytes(s, len);
+
+		if ( StringVal* sv = interned_strings->Lookup(s, len, h) )
+			{
+			::Ref(sv);
+			return sv;
+			}
+		}
+
+	return new StringVal(len, s);
+	}
+
+StringVal* ValManager::GetInternedString(const char* s)
+	{
+	return GetInternedString(strlen(s), s);
+	}
+
+StringVal* ValManager::GetInternedUpperString(int len, const char* s)
+	{
+	if ( len > MAX_INTERNED_STRING_LENGTH )
+		return (new StringVal(len, s))->ToUpper();
+
+	char upper[MAX_INTERNED_STRING_LENGTH];
+
+	for ( int i = 0; i < len; ++i )
+		upper[i] = toupper((unsigned char) s[i]);
+
+	return GetInternedString(len, upper);
+	}
+
+TEST_CASE("intern pool shares only registered strings")
+	{
+	ValManager* vm = new ValManager();
+	vm->InternString("GET");
+
+	StringVal* a = vm->GetInternedString("GET");
+	StringVal* b = vm->GetInternedString(3, "GET");
+	StringVal* c = vm->GetInternedUpperString(3, "get");
+	CHECK_EQ(a, b);
+	CHECK_EQ(a, c);
+	CHECK_EQ(a->RefCnt(), 4);
+
+	// Registering a string twice keeps the shared value.
+	vm->InternString("GET");
+	StringVal* d = vm->GetInternedString("GET");
+	CHECK_EQ(a, d);
+
+	// Anything that wasn't registered gets a fresh value every time,
+	// however often it's asked for, and doesn't end up in the pool.
+	for ( int i = 0; i < 3; ++i )
+		{
+		StringVal* x = vm->GetInternedString("GETX");
+		StringVal* y = vm->GetInternedUpperString(4, "getx");
+		CHECK_NE(x, y);
+		CHECK_EQ(x->RefCnt(), 1);
+		CHECK_EQ(y->RefCnt(), 1);
+		CHECK_EQ(*y->AsString(), BroString("GETX"));
+		Unref(x);
+		Unref(y);
+		}
+
+	// So does anything past the length limit.
+	std::string s(ValManager::MAX_INTERNED_STRING_LENGTH + 1, 'a');
+	StringVal* e = vm->GetInternedUpperString(s.size(), s.data());
+	CHECK_EQ(e->Len(), (int) s.size());
+	CHECK_EQ(e->RefCnt(), 1);
+	CHECK_EQ(e->Bytes()[0], 'A');
+	Unref(e);
+
+	Unref(a);
+	Unref(b);
+	Unref(c);
+	Unref(d);
+	delete vm;
+	}
+
 PortVal* ValManager::GetPort(uint32_t port_num, TransportProto port_type) const
 	{
 	if ( port_num >= 65536 )
@@ -6,6 +6,7 @@
 #include <list>
 #include <array>
 #include <unordered_map>
+#include <map>
 
 #include "net_util.h"
 #include "Type.h"
@@ -483,6 +484,27 @@ public:
 
 	StringVal* GetEmptyString() const;
 
+	// Strings up to this length can be added to the intern pool.
+	static constexpr int MAX_INTERNED_STRING_LENGTH = 128;
+
+	// Adds a string to the intern pool.  Only strings added this way
+	// are ever shared.  Analyzers register the fixed keyword sets of
+	// their protocols (methods, commands, common header names) at
+	// startup, so the pool can't grow with what's seen on the wire.
+	void InternString(const char* s);
+
+	// Returns the shared value if the given string is in the intern
+	// pool, and a fresh value otherwise.  The caller must not modify
+	// the value.
+	StringVal* GetInternedString(int len, const char* s);
+	StringVal* GetInternedString(const char* s);
+	StringVal* GetInternedString(const std::string& s)
+		{ return GetInternedString(s.size(), s.data()); }
+
+	// Same, but for the upper-cased version of the given string, as
+	// used for case-insensitive protocol keywords.
+	StringVal* GetInternedUpperString(int len, const char* s);
+
 	// Port number given in host order.
 	PortVal* GetPort(uint32_t port_num, TransportProto port_type) const;
 
@@ -493,6 +515,7 @@ private:
 
 	std::array<std::array<PortVal*, 65536>, NUM_PORT_SPACES> ports;
 	StringVal* empty_string;
+	PDict<StringVal>* interned_strings;
 	Val* b_true;
 	Val* b_false;
 	Val** counts;
@@ -719,6 +742,18 @@ protected:
 
 extern double bro_start_network_time;
 
+// An entry's place in its table's expiration index (see TableVal).  The
+// key points to the table dictionary's own copy of the entry's key.
+struct TableExpireNode {
+	TableEntryVal* entry;
+	TableExpireNode* prev;
+	TableExpireNode* next;
+	const void* key;
+	int key_size;
+	hash_t hash;
+	int bucket;	// the entry's expire_access_time when filed
+};
+
 class TableEntryVal {
 public:
 	explicit TableEntryVal(Val* v)
@@ -727,6 +762,7 @@ public:
 		last_access_time = network_time;
 		expire_access_time =
 			int(network_time - bro_start_network_time);
+		expire_node = 0;
 		}
 
 	TableEntryVal* Clone(Val::CloneState* state)
@@ -759,6 +795,9 @@ protected:
 	// to save a few bytes, as we do not need a high resolution for these
 	// anyway.
 	int expire_access_time;
+
+	// Non-nil if the entry is part of its table's expiration index.
+	TableExpireNode* expire_node;
 };
 
 class TableValTimer : public Timer {
@@ -782,6 +821,20 @@ public:
 	explicit TableVal(TableType* t, Attributes* attrs = 0);
 	~TableVal() override;
 
+	// Statistics about table expiration, accumulated across all tables.
+	struct ExpireStats {
+		uint64_t rounds;	// DoExpire() invocations
+		uint64_t examined;	// due entries looked at
+		uint64_t expired;	// entries removed
+		uint64_t postponed;	// entries kept alive by &expire_func
+		uint64_t max_examined;	// most entries looked at in one round
+		uint64_t incomplete;	// rounds that ran out of budget
+		double total_lag;	// sum of (removal time - due time)
+		double max_lag;		// largest single removal lag
+	};
+
+	static const ExpireStats& GetExpireStats()	{ return expire_stats; }
+
 	// Returns true if the assignment typechecked, false if not. The
 	// methods take ownership of new_val, but not of the index. Second
 	// version takes a HashKey and Unref()'s it when done. If we're a
@@ -835,6 +888,10 @@ public:
 	// need to Ref/Unref it when calling the default function.
 	Val* Lookup(Val* index, bool use_default_val = true);
 
+	// Same, but with the index given as an array of n values, which
+	// avoids building a ListVal for atomic index types.
+	Val* Lookup(Val* const* index_vals, int n, bool use_default_val = true);
+
 	// For a table[subnet]/set[subnet], return all subnets that cover
 	// the given subnet.
 	// Causes an internal error if called for any other kind of table.
@@ -895,6 +952,10 @@ public:
 	HashKey* ComputeHash(const Val* index) const
 		{ return table_hash->ComputeHash(index, 1); }
 
+	// Looks up the entry for an index given as n values without
+	// allocating a HashKey.  Requires an atomic index type.
+	TableEntryVal* LookupEntry(const Val* const* index_vals, int n) const;
+
 	notifier::Modifiable* Modifiable() override	{ return this; }
 
 protected:
@@ -922,6 +983,40 @@ protected:
 	// takes ownership of the reference.
 	double CallExpireFunc(Val *idx);
 
+	// Expires (or postpones, per &expire_func) the entry for the given
+	// key if it's still due.  Returns true if the entry got removed.
+	bool ExpireEntry(const HashKey* k, double t, double timeout);
+
+	// Maintenance of the expiration index.  Entries are filed into
+	// buckets keyed by their expire_access_time, so that DoExpire()
+	// only ever needs to look at those at the front that are due.
+	void ExpireIndexInsert(TableEntryVal* v, const void* key,
+				int key_size, hash_t hash);
+	void ExpireIndexRemove(TableEntryVal* v);
+	void ExpireIndexBuild();
+	void ExpireIndexClear();
+	void ExpireIndexLink(TableExpireNode* n);
+	void ExpireIndexUnlink(TableExpireNode* n);
+
+	// Sets the entry's expiration-relevant access time, refiling it
+	// in the expiration index as needed.
+	void SetExpireAccess(TableEntryVal* v, double t)
+		{
+		v->SetExpireAccess(t);
+		ExpireIndexRefile(v);
+		}
+
+	void ExpireIndexRefile(TableEntryVal* v)
+		{
+		if ( v->expire_node &&
+		     v->expire_node->bucket != v->expire_access_time )
+			{
+			ExpireIndexUnlink(v->expire_node);
+			v->expire_node->bucket = v->expire_access_time;
+			ExpireIndexLink(v->expire_node);
+			}
+		}
+
 	Val* DoClone(CloneState* state) override;
 
 	TableType* table_type;
@@ -930,9 +1025,17 @@ protected:
 	Expr* expire_time;
 	Expr* expire_func;
 	TableValTimer* timer;
-	IterCookie* expire_cookie;
 	PrefixTable* subnets;
 	Val* def_val;
+
+	struct ExpireBucket {
+		TableExpireNode* head;
+		TableExpireNode* tail;
+	};
+
+	std::map<int, ExpireBucket> expire_buckets;
+
+	static ExpireStats expire_stats;
 };
 
 class RecordVal : public Val, public notifier::Modifiable {
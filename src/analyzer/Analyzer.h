@@ -454,6 +454,12 @@ public:
 	 */
 	const analyzer_list& GetChildren()	{ return children; }
 
+	/**
+	 * Returns true if there are child analyzers queued up to be added,
+	 * i.e., ones that aren't yet part of GetChildren().
+	 */
+	bool HasNewChildren() const	{ return ! new_children.empty(); }
+
 	/**
 	 * Returns a pointer to the parent analyzer, or null if this instance
 	 * has not yet been added to an analyzer tree.
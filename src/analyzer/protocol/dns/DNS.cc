@@ -85,16 +85,19 @@ int DNS_Interpreter::ParseMessage(const u_char* data, int len, int is_query)
 
 	analyzer->ProtocolConfirmation();
 
-	AddrVal server(analyzer->Conn()->RespAddr());
-
 	int skip_auth = dns_skip_all_auth;
 	int skip_addl = dns_skip_all_addl;
 	if ( msg.ancount > 0 )
 		{ // We did an answer, so can potentially skip auth/addl.
-		skip_auth = skip_auth || msg.nscount == 0 ||
-				dns_skip_auth->Lookup(&server);
-		skip_addl = skip_addl || msg.arcount == 0 ||
-				dns_skip_addl->Lookup(&server);
+		skip_auth = skip_auth || msg.nscount == 0;
+		skip_addl = skip_addl || msg.arcount == 0;
+
+		if ( ! (skip_auth && skip_addl) )
+			{
+			AddrVal server(analyzer->Conn()->RespAddr());
+			skip_auth = skip_auth || dns_skip_auth->Lookup(&server);
+			skip_addl = skip_addl || dns_skip_addl->Lookup(&server);
+			}
 		}
 
 	if ( skip_auth && skip_addl )
@@ -215,8 +218,10 @@ int DNS_Interpreter::ParseAnswer(DNS_MsgInfo* msg,
 				const u_char*& data, int& len,
 				const u_char* msg_start)
 	{
-	u_char name[513];
-	int name_len = sizeof(name) - 1;
+	// The name goes straight into the message's buffer; its value is
+	// only built if an event needs it.
+	u_char* name = msg->query_name_buf;
+	int name_len = sizeof(msg->query_name_buf) - 1;
 
 	u_char* name_end = ExtractName(data, len, name, name_len, msg_start);
 
@@ -233,7 +238,8 @@ int DNS_Interpreter::ParseAnswer(DNS_MsgInfo* msg,
 	// re-interpreted by other, more adventurous RR types.
 
 	Unref(msg->query_name);
-	msg->query_name = new StringVal(new BroString(name, name_end - name, 1));
+	msg->query_name = 0;
+	msg->query_name_len = name_end - name;
 	msg->atype = RR_Type(ExtractShort(data, len));
 	msg->aclass = ExtractShort(data, len);
 	msg->ttl = ExtractLong(data, len);
@@ -363,8 +369,39 @@ u_char* DNS_Interpreter::ExtractName(const u_char*& data, int& len,
 	{
 	u_char* name_start = name;
 
-	while ( ExtractLabel(data, len, name, name_len, msg_start) )
-		;
+	// Compression pointers are followed by moving a separate cursor, so
+	// that the caller's position ends up right after the first pointer.
+	const u_char* cur = data;
+	int cur_len = len;
+	bool followed_pointer = false;
+	const u_char* target;
+	int target_len;
+	int status;
+
+	while ( (status = ExtractLabel(cur, cur_len, name, name_len, msg_start,
+				       target, target_len)) )
+		{
+		if ( status != LABEL_POINTER )
+			continue;
+
+		if ( ! followed_pointer )
+			{
+			data = cur;
+			len = cur_len;
+			followed_pointer = true;
+			}
+
+		// Pointers only ever lead to earlier parts of the message, so
+		// following them can't loop.
+		cur = target;
+		cur_len = target_len;
+		}
+
+	if ( ! followed_pointer )
+		{
+		data = cur;
+		len = cur_len;
+		}
 
 	int n = name - name_start;
 
@@ -388,10 +425,11 @@ u_char* DNS_Interpreter::ExtractName(const u_char*& data, int& len,
 
 int DNS_Interpreter::ExtractLabel(const u_char*& data, int& len,
 				u_char*& name, int& name_len,
-				const u_char* msg_start)
+				const u_char* msg_start,
+				const u_char*& target, int& target_len)
 	{
 	if ( len <= 0 )
-		return 0;
+		return LABEL_END;
 
 	const u_char* orig_data = data;
 	int label_len = data[0];
@@ -400,11 +438,11 @@ int DNS_Interpreter::ExtractLabel(const u_char*& data, int& len,
 	--len;
 
 	if ( len <= 0 )
-		return 0;
+		return LABEL_END;
 
 	if ( label_len == 0 )
 		// Found terminating label.
-		return 0;
+		return LABEL_END;
 
 	if ( (label_len & 0xc0) == 0xc0 )
 		{
@@ -426,20 +464,14 @@ int DNS_Interpreter::ExtractLabel(const u_char*& data, int& len,
 			//  sometimes compression points to compression.)
 
 			analyzer->Weird("DNS_label_forward_compress_offset");
-			return 0;
+			return LABEL_END;
 			}
 
-		// Recursively resolve name.
-		const u_char* recurse_data = msg_start + offset;
-		int recurse_max_len = orig_data - recurse_data;
-
-		u_char* name_end = ExtractName(recurse_data, recurse_max_len,
-						name, name_len, msg_start);
-
-		name_len -= name_end - name;
-		name = name_end;
-
-		return 0;
+		// The caller continues with the name at the target, which
+		// ends where the pointer starts.
+		target = msg_start + offset;
+		target_len = orig_data - target;
+		return LABEL_POINTER;
 		}
 
 	if ( label_len > len )
@@ -447,7 +479,7 @@ int DNS_Interpreter::ExtractLabel(const u_char*& data, int& len,
 		analyzer->Weird("DNS_label_len_gt_pkt");
 		data += len;	// consume the rest of the packet
 		len = 0;
-		return 0;
+		return LABEL_END;
 		}
 
 	if ( label_len > 63 &&
@@ -455,13 +487,13 @@ int DNS_Interpreter::ExtractLabel(const u_char*& data, int& len,
 		ntohs(analyzer->Conn()->RespPort()) != 137 )
 		{
 		analyzer->Weird("DNS_label_too_long");
-		return 0;
+		return LABEL_END;
 		}
 
 	if ( label_len >= name_len )
 		{
 		analyzer->Weird("DNS_label_len_gt_name_len");
-		return 0;
+		return LABEL_END;
 		}
 
 	memcpy(name, data, label_len);
@@ -473,7 +505,7 @@ int DNS_Interpreter::ExtractLabel(const u_char*& data, int& len,
 	data += label_len;
 	len -= label_len;
 
-	return 1;
+	return LABEL_DATA;
 	}
 
 uint16_t DNS_Interpreter::ExtractShort(const u_char*& data, int& len)
@@ -766,8 +798,8 @@ int DNS_Interpreter::ParseRR_TSIG(DNS_MsgInfo* msg,
 	uint32_t sign_time_sec = ExtractLong(data, len);
 	unsigned int sign_time_msec = ExtractShort(data, len);
 	unsigned int fudge = ExtractShort(data, len);
-	BroString* request_MAC;
-	ExtractOctets(data, len, &request_MAC);
+	BroString* request_MAC = 0;
+	ExtractOctets(data, len, dns_TSIG_addl ? &request_MAC : 0);
 	unsigned int orig_id = ExtractShort(data, len);
 	unsigned int rr_error = ExtractShort(data, len);
 	ExtractOctets(data, len, 0);  // Other Data
@@ -1448,6 +1480,7 @@ DNS_MsgInfo::DNS_MsgInfo(DNS_RawMsgHdr* hdr, int arg_is_query)
 	is_query = arg_is_query;
 
 	query_name = 0;
+	query_name_len = 0;
 	atype = TYPE_ALL;
 	aclass = 0;
 	ttl = 0;
@@ -1461,6 +1494,16 @@ DNS_MsgInfo::~DNS_MsgInfo()
 	Unref(query_name);
 	}
 
+StringVal* DNS_MsgInfo::QueryNameVal()
+	{
+	if ( ! query_name )
+		query_name = new StringVal(new BroString(query_name_buf,
+							 query_name_len, 1));
+
+	::Ref(query_name);
+	return query_name;
+	}
+
 Val* DNS_MsgInfo::BuildHdrVal()
 	{
 	RecordVal* r = new RecordVal(dns_msg);
@@ -1486,9 +1529,8 @@ Val* DNS_MsgInfo::BuildAnswerVal()
 	{
 	RecordVal* r = new RecordVal(dns_answer);
 
-	Ref(query_name);
 	r->Assign(0, val_mgr->GetCount(int(answer_type)));
-	r->Assign(1, query_name);
+	r->Assign(1, QueryNameVal());
 	r->Assign(2, val_mgr->GetCount(atype));
 	r->Assign(3, val_mgr->GetCount(aclass));
 	r->Assign(4, new IntervalVal(double(ttl), Seconds));
@@ -1502,9 +1544,8 @@ Val* DNS_MsgInfo::BuildEDNS_Val()
 	// than a regular resource record.
 	RecordVal* r = new RecordVal(dns_edns_additional);
 
-	Ref(query_name);
 	r->Assign(0, val_mgr->GetCount(int(answer_type)));
-	r->Assign(1, query_name);
+	r->Assign(1, QueryNameVal());
 
 	// type = 0x29 or 41 = EDNS
 	r->Assign(2, val_mgr->GetCount(atype));
@@ -1537,9 +1578,8 @@ Val* DNS_MsgInfo::BuildTSIG_Val(struct TSIG_DATA* tsig)
 	RecordVal* r = new RecordVal(dns_tsig_additional);
 	double rtime = tsig->time_s + tsig->time_ms / 1000.0;
 
-	Ref(query_name);
 	// r->Assign(0, val_mgr->GetCount(int(answer_type)));
-	r->Assign(0, query_name);
+	r->Assign(0, QueryNameVal());
 	r->Assign(1, val_mgr->GetCount(int(answer_type)));
 	r->Assign(2, new StringVal(tsig->alg_name));
 	r->Assign(3, new StringVal(tsig->sig));
@@ -1556,8 +1596,7 @@ Val* DNS_MsgInfo::BuildRRSIG_Val(RRSIG_DATA* rrsig)
 	{
 	RecordVal* r = new RecordVal(dns_rrsig_rr);
 
-	Ref(query_name);
-	r->Assign(0, query_name);
+	r->Assign(0, QueryNameVal());
 	r->Assign(1, val_mgr->GetCount(int(answer_type)));
 	r->Assign(2, val_mgr->GetCount(rrsig->type_covered));
 	r->Assign(3, val_mgr->GetCount(rrsig->algorithm));
@@ -1577,8 +1616,7 @@ Val* DNS_MsgInfo::BuildDNSKEY_Val(DNSKEY_DATA* dnskey)
 	{
 	RecordVal* r = new RecordVal(dns_dnskey_rr);
 
-	Ref(query_name);
-	r->Assign(0, query_name);
+	r->Assign(0, QueryNameVal());
 	r->Assign(1, val_mgr->GetCount(int(answer_type)));
 	r->Assign(2, val_mgr->GetCount(dnskey->dflags));
 	r->Assign(3, val_mgr->GetCount(dnskey->dprotocol));
@@ -1593,8 +1631,7 @@ Val* DNS_MsgInfo::BuildNSEC3_Val(NSEC3_DATA* nsec3)
 	{
 	RecordVal* r = new RecordVal(dns_nsec3_rr);
 
-	Ref(query_name);
-	r->Assign(0, query_name);
+	r->Assign(0, QueryNameVal());
 	r->Assign(1, val_mgr->GetCount(int(answer_type)));
 	r->Assign(2, val_mgr->GetCount(nsec3->nsec_flags));
 	r->Assign(3, val_mgr->GetCount(nsec3->nsec_hash_algo));
@@ -1613,8 +1650,7 @@ Val* DNS_MsgInfo::BuildDS_Val(DS_DATA* ds)
 	{
 	RecordVal* r = new RecordVal(dns_ds_rr);
 
-	Ref(query_name);
-	r->Assign(0, query_name);
+	r->Assign(0, QueryNameVal());
 	r->Assign(1, val_mgr->GetCount(int(answer_type)));
 	r->Assign(2, val_mgr->GetCount(ds->key_tag));
 	r->Assign(3, val_mgr->GetCount(ds->algorithm));
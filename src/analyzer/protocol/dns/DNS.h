@@ -189,6 +189,10 @@ public:
 	Val* BuildNSEC3_Val(struct NSEC3_DATA*);
 	Val* BuildDS_Val(struct DS_DATA*);
 
+	// Returns the name of the current answer, building its value on
+	// first use.
+	StringVal* QueryNameVal();
+
 	int id;
 	int opcode;	///< query type, see DNS_Opcode
 	int rcode;	///< return code, see DNS_Code
@@ -204,7 +208,9 @@ public:
 	int arcount;	///< number of additional RRs
 	int is_query;	///< whether it came from the session initiator
 
-	StringVal* query_name;
+	StringVal* query_name;	///< built from query_name_buf on demand
+	u_char query_name_buf[513];
+	int query_name_len;
 	RR_Type atype;
 	int aclass;	///< normally = 1, inet
 	uint32_t ttl;
@@ -244,9 +250,17 @@ protected:
 	u_char* ExtractName(const u_char*& data, int& len,
 				u_char* label, int label_len,
 				const u_char* msg_start);
+
+	// Return values of ExtractLabel().
+	enum { LABEL_END, LABEL_DATA, LABEL_POINTER };
+
+	// Appends the next label of a name to "label", or, for a
+	// compression pointer, returns where the name continues via
+	// "target" and "target_len".
 	int ExtractLabel(const u_char*& data, int& len,
 			 u_char*& label, int& label_len,
-			 const u_char* msg_start);
+			 const u_char* msg_start,
+			 const u_char*& target, int& target_len);
 
 	uint16_t ExtractShort(const u_char*& data, int& len);
 	uint32_t ExtractLong(const u_char*& data, int& len);
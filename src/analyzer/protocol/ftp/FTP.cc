@@ -15,6 +15,23 @@
 
 using namespace analyzer::ftp;
 
+static const char* ftp_keywords[] = {
+	"USER", "PASS", "ACCT", "CWD", "CDUP", "SMNT", "QUIT", "REIN",
+	"PORT", "PASV", "TYPE", "STRU", "MODE", "RETR", "STOR", "STOU",
+	"APPE", "ALLO", "REST", "RNFR", "RNTO", "ABOR", "DELE", "RMD",
+	"MKD", "PWD", "LIST", "NLST", "SITE", "SYST", "STAT", "HELP",
+	"NOOP", "FEAT", "OPTS", "AUTH", "ADAT", "PBSZ", "PROT", "CCC",
+	"EPRT", "EPSV", "LANG", "MDTM", "SIZE", "MLST", "MLSD", "CLNT",
+	"XCWD", "XPWD", "XMKD", "XRMD",
+	"<missing>",
+};
+
+void FTP_Analyzer::InternKeywords()
+	{
+	for ( auto kw : ftp_keywords )
+		val_mgr->InternString(kw);
+	}
+
 FTP_Analyzer::FTP_Analyzer(Connection* conn)
 : tcp::TCP_ApplicationAnalyzer("FTP", conn)
 	{
@@ -89,10 +106,10 @@ void FTP_Analyzer::DeliverStream(int length, const u_char* data, bool orig)
 		if ( cmd_len == 0 )
 			{
 			// Weird("FTP command missing", end_of_line - orig_line, orig_line);
-			cmd_str = new StringVal("<missing>");
+			cmd_str = val_mgr->GetInternedString("<missing>");
 			}
 		else
-			cmd_str = (new StringVal(cmd_len, cmd))->ToUpper();
+			cmd_str = val_mgr->GetInternedUpperString(cmd_len, cmd);
 
 		vl = val_list{
 			BuildConnVal(),
@@ -19,6 +19,9 @@ public:
 		return new FTP_Analyzer(conn);
 		}
 
+	// Adds FTP commands to the string intern pool.
+	static void InternKeywords();
+
 protected:
 	login::NVT_Analyzer* nvt_orig;
 	login::NVT_Analyzer* nvt_resp;
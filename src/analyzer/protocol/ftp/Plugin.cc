@@ -20,6 +20,11 @@ public:
 		config.description = "FTP analyzer";
 		return config;
 		}
+
+	void InitPreScript() override
+		{
+		::analyzer::ftp::FTP_Analyzer::InternKeywords();
+		}
 } plugin;
 
 }
@@ -838,6 +838,20 @@ void HTTP_Message::Weird(const char* msg)
 	analyzer->Weird(msg);
 	}
 
+static const char* http_keywords[] = {
+	"GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS",
+	"TRACE", "PATCH", "PROPFIND", "PROPPATCH", "MKCOL", "COPY", "MOVE",
+	"LOCK", "UNLOCK", "SEARCH", "REPORT",
+	"0.9", "1.0", "1.1", "2.0",
+	"<empty>",
+};
+
+void HTTP_Analyzer::InternKeywords()
+	{
+	for ( auto kw : http_keywords )
+		val_mgr->InternString(kw);
+	}
+
 HTTP_Analyzer::HTTP_Analyzer(Connection* conn)
 : tcp::TCP_ApplicationAnalyzer("HTTP", conn)
 	{
@@ -1265,7 +1279,7 @@ int HTTP_Analyzer::HTTP_RequestLine(const char* line, const char* end_of_line)
 	if ( rest == end_of_method )
 		goto error;
 
-	request_method = new StringVal(end_of_method - line, line);
+	request_method = val_mgr->GetInternedString(end_of_method - line, line);
 
 	if ( ! ParseRequest(rest, end_of_line) )
 		{
@@ -1435,7 +1449,7 @@ void HTTP_Analyzer::HTTP_Request()
 			request_method,
 			TruncateURI(request_URI->AsStringVal()),
 			TruncateURI(unescaped_URI->AsStringVal()),
-			new StringVal(fmt("%.1f", request_version)),
+			val_mgr->GetInternedString(fmt("%.1f", request_version)),
 		});
 		}
 	}
@@ -1446,11 +1460,11 @@ void HTTP_Analyzer::HTTP_Reply()
 		{
 		ConnectionEventFast(http_reply, {
 			BuildConnVal(),
-			new StringVal(fmt("%.1f", reply_version)),
+			val_mgr->GetInternedString(fmt("%.1f", reply_version)),
 			val_mgr->GetCount(reply_code),
 			reply_reason_phrase ?
 				reply_reason_phrase->Ref() :
-				new StringVal("<empty>"),
+				val_mgr->GetInternedString("<empty>"),
 		});
 		}
 	else
@@ -1691,7 +1705,7 @@ void HTTP_Analyzer::HTTP_Header(int is_orig, mime::MIME_Header* h)
 		ConnectionEventFast(http_header, {
 			BuildConnVal(),
 			val_mgr->GetBool(is_orig),
-			mime::new_string_val(h->get_name())->ToUpper(),
+			mime::new_header_name_val(h->get_name()),
 			mime::new_string_val(h->get_value()),
 		});
 		}
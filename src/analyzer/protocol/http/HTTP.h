@@ -114,6 +114,7 @@ public:
 	void SubmitAllHeaders(mime::MIME_HeaderList& /* hlist */) override;
 	void SubmitData(int len, const char* buf) override;
 	int RequestBuffer(int* plen, char** pbuf) override;
+	bool SubmitsInPlace() const override	{ return true; }
 	void SubmitAllData();
 	void SubmitEvent(int event_type, const char* detail) override;
 
@@ -189,6 +190,9 @@ public:
 			http_content_type || http_entity_data || http_message_done ||
 			http_event || http_stats); }
 
+	// Adds HTTP methods and versions to the string intern pool.
+	static void InternKeywords();
+
 protected:
 	void GenStats();
 
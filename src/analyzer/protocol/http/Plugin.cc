@@ -19,6 +19,11 @@ public:
 		config.description = "HTTP analyzer";
 		return config;
 		}
+
+	void InitPreScript() override
+		{
+		::analyzer::http::HTTP_Analyzer::InternKeywords();
+		}
 } plugin;
 
 }
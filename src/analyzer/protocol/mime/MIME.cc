@@ -123,6 +123,43 @@ StringVal* new_string_val(const data_chunk_t buf)
 	return new_string_val(buf.length, buf.data);
 	}
 
+// Header names repeat across nearly all messages, so the upper-cased
+// values of common ones come from the intern pool instead of being built
+// for every header.
+StringVal* new_header_name_val(const data_chunk_t name)
+	{
+	return val_mgr->GetInternedUpperString(name.length, name.data);
+	}
+
+static const char* common_header_names[] = {
+	// Message and entity headers.
+	"CONTENT-TYPE", "CONTENT-LENGTH", "CONTENT-ENCODING",
+	"CONTENT-TRANSFER-ENCODING", "CONTENT-DISPOSITION", "CONTENT-ID",
+	"CONTENT-DESCRIPTION", "CONTENT-LANGUAGE", "CONTENT-LOCATION",
+	"CONTENT-RANGE", "MIME-VERSION", "DATE",
+
+	// HTTP.
+	"HOST", "USER-AGENT", "ACCEPT", "ACCEPT-CHARSET",
+	"ACCEPT-ENCODING", "ACCEPT-LANGUAGE", "ACCEPT-RANGES", "AGE",
+	"AUTHORIZATION", "CACHE-CONTROL", "CONNECTION", "COOKIE", "ETAG",
+	"EXPIRES", "IF-MODIFIED-SINCE", "IF-NONE-MATCH", "KEEP-ALIVE",
+	"LAST-MODIFIED", "LOCATION", "ORIGIN", "PRAGMA",
+	"PROXY-AUTHORIZATION", "PROXY-CONNECTION", "RANGE", "REFERER",
+	"SERVER", "SET-COOKIE", "TRANSFER-ENCODING", "UPGRADE", "VARY",
+	"VIA", "WWW-AUTHENTICATE", "X-FORWARDED-FOR", "X-POWERED-BY",
+
+	// Mail.
+	"FROM", "TO", "CC", "BCC", "SUBJECT", "MESSAGE-ID", "IN-REPLY-TO",
+	"REFERENCES", "REPLY-TO", "RETURN-PATH", "RECEIVED", "SENDER",
+	"X-MAILER", "X-ORIGINATING-IP",
+};
+
+void intern_header_names()
+	{
+	for ( auto name : common_header_names )
+		val_mgr->InternString(name);
+	}
+
 static data_chunk_t get_data_chunk(BroString* s)
 	{
 	data_chunk_t b;
@@ -1033,7 +1070,10 @@ void MIME_Entity::DecodeBinary(int len, const char* data, int trailing_CRLF)
 		DataOctet(LF);
 		}
 
-	DataOctets(len, data);
+	if ( message->SubmitsInPlace() )
+		DataOctetsInPlace(len, data);
+	else
+		DataOctets(len, data);
 
 	if ( trailing_CRLF )
 		{
@@ -1056,6 +1096,14 @@ void MIME_Entity::DecodeBinary(int len, const char* data, int trailing_CRLF)
 		}
 	}
 
+// Whether a character stands for itself in quoted-printable encoding:
+// printables except '=', and whitespace.
+static inline bool is_qp_literal(char ch)
+	{
+	return (ch >= 33 && ch <= 60) || (ch >= 62 && ch <= 126) ||
+		ch == HT || ch == SP;
+	}
+
 void MIME_Entity::DecodeQuotedPrintable(int len, const char* data)
 	{
 	// Ignore trailing HT and SP.
@@ -1069,7 +1117,19 @@ void MIME_Entity::DecodeQuotedPrintable(int len, const char* data)
 
 	for ( i = 0; i <= end_of_line; ++i )
 		{
-		if ( data[i] == '=' )
+		if ( is_qp_literal(data[i]) )
+			{
+			// Pass on runs of literal characters in one go.
+			int j = i + 1;
+
+			while ( j <= end_of_line && is_qp_literal(data[j]) )
+				++j;
+
+			DataOctets(j - i, data + i);
+			i = j - 1;
+			}
+
+		else if ( data[i] == '=' )
 			{
 			if ( i == end_of_line )
 				soft_line_break = 1;
@@ -1100,14 +1160,6 @@ void MIME_Entity::DecodeQuotedPrintable(int len, const char* data)
 				}
 			}
 
-		else if ( (data[i] >= 33 && data[i] <= 60) ||
-			   // except controls, whitespace and '='
-			  (data[i] >= 62 && data[i] <= 126) )
-			DataOctet(data[i]);
-
-		else if ( data[i] == HT || data[i] == SP )
-			DataOctet(data[i]);
-
 		else
 			{
 			IllegalEncoding(fmt("control characters in quoted-printable encoding: %d", (int) (data[i])));
@@ -1124,16 +1176,56 @@ void MIME_Entity::DecodeQuotedPrintable(int len, const char* data)
 
 void MIME_Entity::DecodeBase64(int len, const char* data)
 	{
-	int rlen;
-	char rbuf[128];
+	if ( ! base64_decoder )
+		return;
 
-	while ( len > 0 )
+	// Decode straight into the data buffer.  Only the bytes that
+	// straddle the end of a buffer go through a group-sized bounce
+	// buffer, so that the buffers get filled exactly as with
+	// DataOctets().
+	while ( len > 0 || base64_decoder->HasPendingGroup() )
 		{
-		rlen = 128;
-		char* prbuf = rbuf;
+		if ( data_buf_offset < 0 && ! GetDataBuffer() )
+			{
+			// Nobody takes the data, but keep decoding so that
+			// malformed input still gets reported.
+			char discard[128];
+			int rlen = sizeof(discard);
+			char* prbuf = discard;
+			int decoded = base64_decoder->Decode(len, data, &rlen, &prbuf);
+			len -= decoded;
+			data += decoded;
+			continue;
+			}
+
+		char rbuf[3];
+		int rlen = data_buf_length - data_buf_offset;
+		char* prbuf = data_buf_data + data_buf_offset;
+		bool in_place = rlen >= int(sizeof(rbuf));
+
+		if ( ! in_place )
+			{
+			rlen = sizeof(rbuf);
+			prbuf = rbuf;
+			}
+
 		int decoded = base64_decoder->Decode(len, data, &rlen, &prbuf);
-		DataOctets(rlen, rbuf);
-		len -= decoded; data += decoded;
+		len -= decoded;
+		data += decoded;
+
+		if ( ! in_place )
+			{
+			DataOctets(rlen, rbuf);
+			continue;
+			}
+
+		data_buf_offset += rlen;
+
+		if ( data_buf_offset == data_buf_length )
+			{
+			SubmitData(data_buf_length, data_buf_data);
+			data_buf_offset = -1;
+			}
 		}
 	}
 
@@ -1229,6 +1321,27 @@ void MIME_Entity::DataOctets(int len, const char* data)
 		}
 	}
 
+void MIME_Entity::DataOctetsInPlace(int len, const char* data)
+	{
+	// Only spans that would fill an empty buffer completely get passed
+	// on directly.  Anything else gets copied as usual, so that it's
+	// combined with the surrounding data into the same chunks.
+	while ( len > 0 )
+		{
+		if ( data_buf_offset < 0 && ! GetDataBuffer() )
+			return;
+
+		if ( data_buf_offset > 0 || len < data_buf_length )
+			break;
+
+		SubmitData(data_buf_length, data);
+		data += data_buf_length;
+		len -= data_buf_length;
+		}
+
+	DataOctets(len, data);
+	}
+
 void MIME_Entity::FlushData()
 	{
 	if ( data_buf_offset > 0 )
@@ -1292,7 +1405,7 @@ void MIME_Entity::DebugPrintHeaders()
 RecordVal* MIME_Message::BuildHeaderVal(MIME_Header* h)
 	{
 	RecordVal* header_record = new RecordVal(mime_header_rec);
-	header_record->Assign(0, new_string_val(h->get_name())->ToUpper());
+	header_record->Assign(0, new_header_name_val(h->get_name()));
 	header_record->Assign(1, new_string_val(h->get_value()));
 	return header_record;
 	}
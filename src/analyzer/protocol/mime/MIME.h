@@ -130,6 +130,9 @@ protected:
 	int GetDataBuffer();
 	void DataOctet(char ch);
 	void DataOctets(int len, const char* data);
+	// Like DataOctets(), but submits full buffer-sized spans without
+	// copying them into the data buffer first.
+	void DataOctetsInPlace(int len, const char* data);
 	void FlushData();
 	virtual void SubmitData(int len, const char* buf);
 
@@ -217,6 +220,11 @@ public:
 	virtual int RequestBuffer(int* plen, char** pbuf) = 0;
 	virtual void SubmitEvent(int event_type, const char* detail) = 0;
 
+	// Whether SubmitData() also takes data that doesn't live in the
+	// buffer handed out by RequestBuffer(), which lets entities pass
+	// on body data without copying it first.
+	virtual bool SubmitsInPlace() const	{ return false; }
+
 protected:
 	analyzer::Analyzer* analyzer;
 
@@ -266,6 +274,8 @@ extern int is_null_data_chunk(data_chunk_t b);
 extern StringVal* new_string_val(int length, const char* data);
 extern StringVal* new_string_val(const char* data, const char* end_of_data);
 extern StringVal* new_string_val(const data_chunk_t buf);
+extern StringVal* new_header_name_val(const data_chunk_t name);
+extern void intern_header_names();
 extern int fputs(data_chunk_t b, FILE* fp);
 extern bool istrequal(data_chunk_t s, const char* t);
 extern int is_lws(char ch);
@@ -3,6 +3,8 @@
 
 #include "plugin/Plugin.h"
 
+#include "MIME.h"
+
 namespace plugin {
 namespace Zeek_MIME {
 
@@ -15,6 +17,11 @@ public:
 		config.description = "MIME parsing";
 		return config;
 		}
+
+	void InitPreScript() override
+		{
+		::analyzer::mime::intern_header_names();
+		}
 } plugin;
 
 }
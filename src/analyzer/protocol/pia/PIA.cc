@@ -6,6 +6,8 @@
 
 using namespace analyzer::pia;
 
+PIA::Stats PIA::stats;
+
 PIA::PIA(analyzer::Analyzer* arg_as_analyzer)
 	: state(INIT), as_analyzer(arg_as_analyzer), conn(), current_packet()
 	{
@@ -22,29 +24,43 @@ void PIA::ClearBuffer(Buffer* buffer)
 	for ( DataBlock* b = buffer->head; b; b = next )
 		{
 		next = b->next;
+
+		if ( b->data )
+			stats.current_bytes -= b->len;
+
 		delete b->ip;
-		delete [] b->data;
-		delete b;
+		delete [] reinterpret_cast<u_char*>(b);
 		}
 
 	buffer->head = buffer->tail = 0;
 	buffer->size = 0;
 	}
 
-void PIA::AddToBuffer(Buffer* buffer, uint64_t seq, int len, const u_char* data,
+bool PIA::AddToBuffer(Buffer* buffer, uint64_t seq, int len, const u_char* data,
 			bool is_orig, const IP_Hdr* ip)
 	{
-	u_char* tmp = 0;
+	int data_len = data ? len : 0;
+
+	if ( data_len && dpd_max_total_buffer_size &&
+	     stats.current_bytes + data_len > dpd_max_total_buffer_size )
+		{
+		++stats.budget_exceeded;
+		return false;
+		}
+
+	u_char* mem = new u_char[sizeof(DataBlock) + data_len];
+	DataBlock* b = reinterpret_cast<DataBlock*>(mem);
 
 	if ( data )
 		{
-		tmp = new u_char[len];
+		u_char* tmp = mem + sizeof(DataBlock);
 		memcpy(tmp, data, len);
+		b->data = tmp;
 		}
+	else
+		b->data = 0;
 
-	DataBlock* b = new DataBlock;
 	b->ip = ip ? ip->Copy() : 0;
-	b->data = tmp;
 	b->is_orig = is_orig;
 	b->len = len;
 	b->seq = seq;
@@ -59,18 +75,28 @@ void PIA::AddToBuffer(Buffer* buffer, uint64_t seq, int len, const u_char* data,
 		buffer->head = buffer->tail = b;
 
 	buffer->size += len;
+
+	stats.current_bytes += data_len;
+
+	if ( stats.current_bytes > stats.max_bytes )
+		stats.max_bytes = stats.current_bytes;
+
+	return true;
 	}
 
-void PIA::AddToBuffer(Buffer* buffer, int len, const u_char* data, bool is_orig,
+bool PIA::AddToBuffer(Buffer* buffer, int len, const u_char* data, bool is_orig,
                       const IP_Hdr* ip)
 	{
-	AddToBuffer(buffer, -1, len, data, is_orig, ip);
+	return AddToBuffer(buffer, -1, len, data, is_orig, ip);
 	}
 
 void PIA::ReplayPacketBuffer(analyzer::Analyzer* analyzer)
 	{
 	DBG_LOG(DBG_ANALYZER, "PIA replaying %d total packet bytes", pkt_buffer.size);
 
+	++stats.num_replays;
+	stats.replayed_bytes += pkt_buffer.size;
+
 	for ( DataBlock* b = pkt_buffer.head; b; b = b->next )
 		analyzer->DeliverPacket(b->len, b->data, b->is_orig, -1, b->ip, 0);
 	}
@@ -99,8 +125,8 @@ void PIA::PIA_DeliverPacket(int len, const u_char* data, bool is_orig, uint64_t
 	if ( (pkt_buffer.state == BUFFERING || new_state == BUFFERING) &&
 	     len > 0 )
 		{
-		AddToBuffer(&pkt_buffer, seq, len, data, is_orig, ip);
-		if ( pkt_buffer.size > dpd_buffer_size )
+		if ( ! AddToBuffer(&pkt_buffer, seq, len, data, is_orig, ip) ||
+		     pkt_buffer.size > dpd_buffer_size )
 			new_state = dpd_match_only_beginning ?
 						SKIPPING : MATCHING_ONLY;
 		}
@@ -113,6 +139,11 @@ void PIA::PIA_DeliverPacket(int len, const u_char* data, bool is_orig, uint64_t
 
 	pkt_buffer.state = new_state;
 
+	if ( new_state != BUFFERING )
+		// Nothing replays the buffer anymore, so don't let it count
+		// against dpd_max_total_buffer_size until the connection ends.
+		ClearBuffer(&pkt_buffer);
+
 	current_packet.data = 0;
 	}
 
@@ -162,6 +193,7 @@ void PIA_UDP::ActivateAnalyzer(analyzer::Tag tag, const Rule* rule)
 			}
 
 		pkt_buffer.state = dpd_late_match_stop ? SKIPPING : MATCHING_ONLY;
+		ClearBuffer(&pkt_buffer);
 		return;
 		}
 
@@ -268,15 +300,32 @@ void PIA_TCP::DeliverStream(int len, const u_char* data, bool is_orig)
 
 	if ( stream_buffer.state == BUFFERING || new_state == BUFFERING )
 		{
-		AddToBuffer(&stream_buffer, len, data, is_orig);
-		if ( stream_buffer.size > dpd_buffer_size )
+		if ( ! AddToBuffer(&stream_buffer, len, data, is_orig) ||
+		     stream_buffer.size > dpd_buffer_size )
 			new_state = dpd_match_only_beginning ?
 						SKIPPING : MATCHING_ONLY;
 		}
 
 	DoMatch(data, len, is_orig, false, false, false, 0);
 
+	if ( new_state == SKIPPING )
+		StopMatching();
+
 	stream_buffer.state = new_state;
+
+	if ( new_state != BUFFERING )
+		ClearBuffer(&stream_buffer);
+	}
+
+void PIA_TCP::StopMatching()
+	{
+	if ( stream_buffer.state == SKIPPING )
+		return;
+
+	// We won't look at the stream anymore, so as far as we're
+	// concerned reassembly can stop delivering it.
+	SkipStream(true, UINT64_MAX);
+	SkipStream(false, UINT64_MAX);
 	}
 
 void PIA_TCP::Undelivered(uint64_t seq, int len, bool is_orig)
@@ -292,7 +341,10 @@ void PIA_TCP::Undelivered(uint64_t seq, int len, bool is_orig)
 
 void PIA_TCP::ActivateAnalyzer(analyzer::Tag tag, const Rule* rule)
 	{
-	if ( stream_buffer.state == MATCHING_ONLY )
+	// In packet mode, it's the packet buffer that would get replayed.
+	Buffer* buffer = stream_mode ? &stream_buffer : &pkt_buffer;
+
+	if ( buffer->state == MATCHING_ONLY )
 		{
 		DBG_LOG(DBG_ANALYZER, "analyzer found but buffer already exceeded");
 		// FIXME: This is where to check whether an analyzer supports
@@ -310,7 +362,11 @@ void PIA_TCP::ActivateAnalyzer(analyzer::Tag tag, const Rule* rule)
 			});
 			}
 
-		stream_buffer.state = dpd_late_match_stop ? SKIPPING : MATCHING_ONLY;
+		if ( dpd_late_match_stop )
+			StopMatching();
+
+		buffer->state = dpd_late_match_stop ? SKIPPING : MATCHING_ONLY;
+		ClearBuffer(buffer);
 		return;
 		}
 
@@ -427,6 +483,9 @@ void PIA_TCP::ReplayStreamBuffer(analyzer::Analyzer* analyzer)
 	{
 	DBG_LOG(DBG_ANALYZER, "PIA_TCP replaying %d total stream bytes", stream_buffer.size);
 
+	++stats.num_replays;
+	stats.replayed_bytes += stream_buffer.size;
+
 	for ( DataBlock* b = stream_buffer.head; b; b = b->next )
 		{
 		if ( b->data )
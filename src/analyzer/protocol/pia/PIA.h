@@ -34,6 +34,17 @@ public:
 
 	void ReplayPacketBuffer(analyzer::Analyzer* analyzer);
 
+	// Statistics across all PIA instances.
+	struct Stats {
+		uint64_t current_bytes;	// bytes currently buffered
+		uint64_t max_bytes;	// maximum bytes buffered at any time
+		uint64_t num_replays;	// number of buffer replays
+		uint64_t replayed_bytes;	// total bytes replayed
+		uint64_t budget_exceeded;	// buffers cut short by global budget
+	};
+
+	static const Stats& GetStats()	{ return stats; }
+
 	// Children are also derived from Analyzer. Return this object
 	// as pointer to an Analyzer.
 	analyzer::Analyzer* AsAnalyzer()	{ return as_analyzer; }
@@ -47,6 +58,8 @@ protected:
 
 	// Buffers one chunk of data.  Used both for packet payload (incl.
 	// sequence numbers for TCP) and chunks of a reassembled stream.
+	// The payload is stored inline directly behind the block, so that
+	// buffering a chunk takes a single allocation.
 	struct DataBlock {
 		IP_Hdr* ip;
 		const u_char* data;
@@ -65,9 +78,11 @@ protected:
 		State state;
 	};
 
-	void AddToBuffer(Buffer* buffer, uint64_t seq, int len,
+	// Returns false if the chunk was not buffered because doing so
+	// would exceed dpd_max_total_buffer_size.
+	bool AddToBuffer(Buffer* buffer, uint64_t seq, int len,
 				const u_char* data, bool is_orig, const IP_Hdr* ip = 0);
-	void AddToBuffer(Buffer* buffer, int len,
+	bool AddToBuffer(Buffer* buffer, int len,
 				const u_char* data, bool is_orig, const IP_Hdr* ip = 0);
 	void ClearBuffer(Buffer* buffer);
 
@@ -80,6 +95,8 @@ protected:
 
 	Buffer pkt_buffer;
 
+	static Stats stats;
+
 private:
 	analyzer::Analyzer* as_analyzer;
 	Connection* conn;
@@ -164,6 +181,9 @@ protected:
 	void DeactivateAnalyzer(analyzer::Tag tag) override;
 
 private:
+	// Called when stream matching stops for good.
+	void StopMatching();
+
 	// FIXME: Not sure yet whether we need both pkt_buffer and stream_buffer.
 	// In any case, it's easier this way...
 	Buffer stream_buffer;
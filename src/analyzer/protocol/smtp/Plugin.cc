@@ -19,6 +19,11 @@ public:
 		config.description = "SMTP analyzer";
 		return config;
 		}
+
+	void InitPreScript() override
+		{
+		::analyzer::smtp::SMTP_Analyzer::InternKeywords();
+		}
 } plugin;
 
 }
@@ -26,6 +26,14 @@ static const char* unknown_cmd = "(UNKNOWN)";
 #define SMTP_CMD_WORD(code) ((code >= 0) ? smtp_cmd_word[code] : unknown_cmd)
 
 
+void SMTP_Analyzer::InternKeywords()
+	{
+	// Some of the entries aren't commands seen on the wire, but
+	// they're just as fixed.
+	for ( auto kw : smtp_cmd_word )
+		val_mgr->InternString(kw);
+	}
+
 SMTP_Analyzer::SMTP_Analyzer(Connection* conn)
 : tcp::TCP_ApplicationAnalyzer("SMTP", conn)
 	{
@@ -858,7 +866,7 @@ void SMTP_Analyzer::RequestEvent(int cmd_len, const char* cmd,
 		ConnectionEventFast(smtp_request, {
 			BuildConnVal(),
 			val_mgr->GetBool(orig_is_sender),
-			(new StringVal(cmd_len, cmd))->ToUpper(),
+			val_mgr->GetInternedUpperString(cmd_len, cmd),
 			new StringVal(arg_len, arg),
 		});
 	}
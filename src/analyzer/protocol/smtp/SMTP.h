@@ -53,6 +53,9 @@ public:
 		return new SMTP_Analyzer(conn);
 		}
 
+	// Adds SMTP commands to the string intern pool.
+	static void InternKeywords();
+
 protected:
 
 	void ProcessLine(int length, const char* line, bool orig);
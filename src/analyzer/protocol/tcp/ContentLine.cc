@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <string.h>
 
 #include "ContentLine.h"
 #include "analyzer/protocol/tcp/TCP.h"
@@ -191,6 +192,65 @@ void ContentLine_Analyzer::DoDeliver(int len, const u_char* data)
 		}
 	}
 
+int ContentLine_Analyzer::DoDeliverInPlace(int len, const u_char* data)
+	{
+	// Only a line that starts with this chunk and isn't preceded by a
+	// CR that still needs its weird check can be passed on from here.
+	if ( offset > 0 || last_char == '\r' )
+		return 0;
+
+	int scan_len = min(len, max_line_length);
+	const u_char* lf = (const u_char*) memchr(data, '\n', scan_len);
+	const u_char* cr = (const u_char*) memchr(data, '\r',
+	                                          lf ? lf - data : scan_len);
+	const u_char* eol = cr ? cr : lf;
+
+	if ( ! eol )
+		// Line continues beyond this chunk, or is overlong.
+		return 0;
+
+	int line_len = eol - data;
+
+	if ( flag_NULs && memchr(data, '\0', line_len) )
+		return 0;
+
+	int seq_len;
+
+	if ( cr )
+		{
+		if ( line_len + 1 < len && cr[1] == '\n' )
+			{
+			seq_len = line_len + 2;
+			last_char = '\n';
+			}
+
+		else if ( (CR_LF_as_EOL & CR_as_EOL) && line_len + 1 < len )
+			{
+			seq_len = line_len + 1;
+			last_char = '\r';
+			}
+
+		else
+			// A CR at the end of the chunk may still be followed
+			// by an LF, and a CR that doesn't end lines needs
+			// the weird check.
+			return 0;
+		}
+
+	else
+		{
+		if ( ! (CR_LF_as_EOL & LF_as_EOL) )
+			return 0;
+
+		seq_len = line_len + 1;
+		last_char = '\n';
+		}
+
+	seq_delivered_in_lines = seq + seq_len;
+	ForwardStream(line_len, data, IsOrig());
+	return seq_len;
+	}
+
 int ContentLine_Analyzer::DoDeliverOnce(int len, const u_char* data)
 	{
 	const u_char* data_start = data;
@@ -198,6 +258,11 @@ int ContentLine_Analyzer::DoDeliverOnce(int len, const u_char* data)
 	if ( len <= 0 )
 		return 0;
 
+	int n = DoDeliverInPlace(len, data);
+
+	if ( n > 0 )
+		return n;
+
 	for ( ; len > 0; --len, ++data )
 		{
 		if ( offset >= buf_len )
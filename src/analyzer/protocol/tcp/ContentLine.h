@@ -73,6 +73,12 @@ protected:
 	void InitBuffer(int size);
 	virtual void DoDeliver(int len, const u_char* data);
 	int DoDeliverOnce(int len, const u_char* data);
+
+	// Passes on the line at the start of the chunk without copying it
+	// into buf if it ends within the chunk.  Returns the number of bytes
+	// consumed, or zero if the line needs buffering.  Note that lines
+	// delivered this way aren't NUL-terminated.
+	int DoDeliverInPlace(int len, const u_char* data);
 	void CheckNUL();
 
 	// Returns the sequence number delivered so far.
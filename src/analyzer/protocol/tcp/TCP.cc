@@ -132,6 +132,7 @@ TCP_Analyzer::TCP_Analyzer(Connection* conn)
 	reassembling = 0;
 	first_packet_seen = 0;
 	is_partial = 0;
+	skip_requested = 0;
 
 	orig = new TCP_Endpoint(this, 1);
 	resp = new TCP_Endpoint(this, 0);
@@ -1756,6 +1757,32 @@ bool TCP_Analyzer::HadGap(bool is_orig) const
 	return endp && endp->HadGap();
 	}
 
+uint64_t TCP_Analyzer::PayloadSkipSeq(bool is_orig)
+	{
+	if ( ! skip_requested || GetOutputHandler() || HasNewChildren() )
+		return 0;
+
+	const analyzer_list& children(GetChildren());
+
+	if ( children.empty() )
+		return 0;
+
+	uint64_t skip_seq = UINT64_MAX;
+
+	LOOP_OVER_CONST_CHILDREN(i)
+		{
+		if ( (*i)->IsFinished() || (*i)->Removing() )
+			continue;
+
+		uint64_t s = static_cast<TCP_ApplicationAnalyzer*>(*i)->StreamSkipSeq(is_orig);
+
+		if ( s < skip_seq )
+			skip_seq = s;
+		}
+
+	return skip_seq;
+	}
+
 void TCP_Analyzer::AddChildPacketAnalyzer(analyzer::Analyzer* a)
 	{
 	DBG_LOG(DBG_ANALYZER, "%s added packet child %s",
@@ -1883,6 +1910,28 @@ void TCP_ApplicationAnalyzer::Init()
 		SetTCP(static_cast<TCP_Analyzer*>(Parent()));
 	}
 
+void TCP_ApplicationAnalyzer::SkipStream(bool is_orig, uint64_t len)
+	{
+	TCP_Analyzer* tcp = TCP();
+
+	if ( ! tcp )
+		return;
+
+	TCP_Endpoint* endp = is_orig ? tcp->Orig() : tcp->Resp();
+
+	if ( ! endp->contents_processor )
+		return;
+
+	uint64_t seq = endp->contents_processor->DataSeq();
+	seq = len > UINT64_MAX - seq ? UINT64_MAX : seq + len;
+
+	if ( seq > skip_seq[is_orig] )
+		{
+		skip_seq[is_orig] = seq;
+		tcp->skip_requested = 1;
+		}
+	}
+
 void TCP_ApplicationAnalyzer::ProtocolViolation(const char* reason,
 						const char* data, int len)
 	{
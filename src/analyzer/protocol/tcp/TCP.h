@@ -45,6 +45,13 @@ public:
 
 	bool HadGap(bool orig) const;
 
+	// Returns the relative sequence number up to which none of the
+	// analyzers receiving the given direction's reassembled stream
+	// needs its payload anymore, as they have requested through
+	// TCP_ApplicationAnalyzer::SkipStream().  Returns 0 if any of them
+	// hasn't.
+	uint64_t PayloadSkipSeq(bool is_orig);
+
 	TCP_Endpoint* Orig() const	{ return orig; }
 	TCP_Endpoint* Resp() const	{ return resp; }
 	int OrigState() const	{ return orig->state; }
@@ -188,17 +195,20 @@ private:
 
 	// Whether we have seen the first ACK from the originator.
 	unsigned int seen_first_ACK: 1;
+
+	// Whether any child has asked to skip stream payload.
+	unsigned int skip_requested: 1;
 };
 
 class TCP_ApplicationAnalyzer : public analyzer::Analyzer {
 public:
 	TCP_ApplicationAnalyzer(const char* name, Connection* conn)
 	: Analyzer(name, conn)
-		{ tcp = 0; }
+		{ tcp = 0; skip_seq[0] = skip_seq[1] = 0; }
 
 	explicit TCP_ApplicationAnalyzer(Connection* conn)
 	: Analyzer(conn)
-		{ tcp = 0; }
+		{ tcp = 0; skip_seq[0] = skip_seq[1] = 0; }
 
 	~TCP_ApplicationAnalyzer() override { }
 
@@ -213,6 +223,20 @@ public:
 
 	void SetTCP(TCP_Analyzer* arg_tcp)	{ tcp = arg_tcp; }
 
+	// Tells the TCP analyzer that we don't need the payload of the
+	// next "len" bytes of the given direction's stream, counting from
+	// what has been delivered so far; UINT64_MAX skips all the rest.
+	// Once all analyzers receiving the stream agree, reassembly stops
+	// buffering and delivering such payload while it continues to
+	// track sequence numbers, so gaps and acks are still accounted
+	// for.  Skipped data is not reported as undelivered.
+	void SkipStream(bool is_orig, uint64_t len);
+
+	// Returns the relative sequence number up to which SkipStream()
+	// has asked to skip, or 0 if it hasn't.
+	uint64_t StreamSkipSeq(bool is_orig) const
+		{ return skip_seq[is_orig]; }
+
 	// The given endpoint's data delivery is complete.
 	virtual void EndpointEOF(bool is_orig);
 
@@ -244,6 +268,7 @@ public:
 
 private:
 	TCP_Analyzer* tcp;
+	uint64_t skip_seq[2];
 };
 
 class TCP_SupportAnalyzer : public analyzer::SupportAnalyzer {
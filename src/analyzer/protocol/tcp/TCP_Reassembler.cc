@@ -508,6 +508,20 @@ int TCP_Reassembler::DataSent(double t, uint64_t seq, int len,
 		len -= amount_acked;
 		}
 
+	// If nobody needs the payload, in-order data only advances the
+	// sequence space, without being buffered.  Data above a hole still
+	// goes through the blocks so that the hole is accounted for.
+	if ( seq <= last_reassem_seq &&
+	     (! HasBlocks() || block_list.LastBlock().upper <= last_reassem_seq) &&
+	     upper_seq <= PayloadSkipSeq() )
+		{
+		if ( upper_seq > last_reassem_seq )
+			last_reassem_seq = upper_seq;
+
+		TrimToSeq(last_reassem_seq);
+		return 1;
+		}
+
 	flags = arg_flags;
 	NewBlock(t, seq, len, data);
 	flags = TCP_Flags();
@@ -633,6 +647,19 @@ void TCP_Reassembler::DeliverBlock(uint64_t seq, int len, const u_char* data)
 	if ( skip_deliveries )
 		return;
 
+	uint64_t skip_seq = PayloadSkipSeq();
+
+	if ( seq + len <= skip_seq )
+		return;
+
+	if ( seq < skip_seq )
+		{
+		uint64_t to_skip = skip_seq - seq;
+		len -= to_skip;
+		data += to_skip;
+		seq = skip_seq;
+		}
+
 	in_delivery = true;
 	Deliver(seq, len, data);
 	in_delivery = false;
@@ -652,6 +679,15 @@ void TCP_Reassembler::SkipToSeq(uint64_t seq)
 		}
 	}
 
+uint64_t TCP_Reassembler::PayloadSkipSeq()
+	{
+	if ( type != Forward || dst_analyzer != tcp_analyzer ||
+	     deliver_tcp_contents || record_contents_file )
+		return 0;
+
+	return tcp_analyzer->PayloadSkipSeq(IsOrig());
+	}
+
 int TCP_Reassembler::DataPending() const
 	{
 	// If we are skipping deliveries, the reassembler will not get called
@@ -87,6 +87,10 @@ private:
 	void Undelivered(uint64_t up_to_seq) override;
 	void Gap(uint64_t seq, uint64_t len);
 
+	// Returns the sequence number up to which the analyzers we deliver
+	// to don't need the payload, see TCP_Analyzer::PayloadSkipSeq().
+	uint64_t PayloadSkipSeq();
+
 	void RecordToSeq(uint64_t start_seq, uint64_t stop_seq, BroFile* f);
 	void RecordBlock(const DataBlock& b, BroFile* f);
 	void RecordGap(uint64_t start_seq, uint64_t upper_seq, BroFile* f);
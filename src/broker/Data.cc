@@ -9,6 +9,10 @@
 #include <caf/stream_deserializer.hpp>
 #include <caf/streambuf.hpp>
 
+#include <deque>
+#include <set>
+#include <unordered_map>
+
 using namespace std;
 
 OpaqueType* bro_broker::opaque_of_data_type;
@@ -791,6 +795,157 @@ IntrusivePtr<Val> bro_broker::data_to_val(broker::data d, BroType* type)
 	return {caf::visit(val_converter{type}, std::move(d)), false};
 	}
 
+namespace {
+
+// The Broker data of values whose types scripts declared immutable, keyed
+// by the values themselves.  The cache holds a reference to each value, so
+// that its address can't get reused for a different value.  A hit still
+// copies the cached data, but skips converting the value field by field.
+class DataCache {
+public:
+	void Configure(size_t arg_max_size, std::set<std::string> names)
+		{
+		Clear();
+		max_size = arg_max_size;
+		type_names = std::move(names);
+		cacheable_types.clear();
+		}
+
+	bool Cacheable(const BroType* t)
+		{
+		if ( ! max_size )
+			return false;
+
+		auto it = cacheable_types.find(t);
+
+		if ( it != cacheable_types.end() )
+			return it->second;
+
+		bool rval = type_names.find(t->GetName()) != type_names.end();
+		cacheable_types[t] = rval;
+		return rval;
+		}
+
+	const broker::data* Lookup(Val* v) const
+		{
+		auto it = entries.find(v);
+		return it != entries.end() ? &it->second : nullptr;
+		}
+
+	void Insert(Val* v, broker::data d)
+		{
+		if ( order.size() >= max_size )
+			{
+			// Evict the oldest entry.
+			Val* old = order.front();
+			order.pop_front();
+			entries.erase(old);
+			Unref(old);
+			}
+
+		entries.emplace(v, std::move(d));
+		order.push_back(v->Ref());
+		}
+
+	void Clear()
+		{
+		for ( auto v : order )
+			Unref(v);
+
+		order.clear();
+		entries.clear();
+		}
+
+	size_t Size() const	{ return entries.size(); }
+
+private:
+	std::unordered_map<Val*, broker::data> entries;
+	std::deque<Val*> order;
+	std::unordered_map<const BroType*, bool> cacheable_types;
+	std::set<std::string> type_names;
+	size_t max_size = 0;
+};
+
+}
+
+static DataCache data_cache;
+
+void bro_broker::init_data_cache(size_t max_size, TableVal* immutable_types)
+	{
+	std::set<std::string> names;
+
+	if ( immutable_types )
+		{
+		ListVal* lv = immutable_types->ConvertToPureList();
+
+		for ( int i = 0; i < lv->Length(); ++i )
+			names.insert(lv->Index(i)->AsString()->CheckString());
+
+		Unref(lv);
+		}
+
+	data_cache.Configure(max_size, std::move(names));
+	}
+
+void bro_broker::clear_data_cache()
+	{
+	data_cache.Clear();
+	}
+
+TEST_CASE("caching Broker data of immutable record types")
+	{
+	type_decl_list* decls = new type_decl_list();
+	decls->push_back(new TypeDecl(base_type(TYPE_COUNT), copy_string("n")));
+	RecordType* rt = new RecordType(decls);
+	rt->SetName("test_id");
+
+	RecordVal* r[3];
+
+	for ( int i = 0; i < 3; ++i )
+		{
+		r[i] = new RecordVal(rt);
+		r[i]->Assign(0, new Val(uint64_t(i), TYPE_COUNT));
+		}
+
+	data_cache.Configure(2, {"test_id"});
+	CHECK(data_cache.Cacheable(rt));
+
+	auto d = bro_broker::val_to_data(r[0]);
+	CHECK(data_cache.Lookup(r[0]));
+	CHECK_EQ(r[0]->RefCnt(), 2);
+
+	// A hit gives the same data.
+	auto again = bro_broker::val_to_data(r[0]);
+	CHECK_EQ(*again, *d);
+	CHECK_EQ(data_cache.Size(), 1u);
+
+	// Once full, the oldest entry makes room and gives up its reference.
+	bro_broker::val_to_data(r[1]);
+	bro_broker::val_to_data(r[2]);
+	CHECK_EQ(data_cache.Size(), 2u);
+	CHECK_FALSE(data_cache.Lookup(r[0]));
+	CHECK_EQ(r[0]->RefCnt(), 1);
+	CHECK(data_cache.Lookup(r[1]));
+	CHECK(data_cache.Lookup(r[2]));
+
+	// Types that aren't listed don't get cached.
+	data_cache.Configure(2, {"other_id"});
+	CHECK_FALSE(data_cache.Cacheable(rt));
+	bro_broker::val_to_data(r[0]);
+	CHECK_EQ(data_cache.Size(), 0u);
+
+	// Neither does anything with a size of zero.
+	data_cache.Configure(0, {"test_id"});
+	CHECK_FALSE(data_cache.Cacheable(rt));
+	bro_broker::val_to_data(r[0]);
+	CHECK_EQ(data_cache.Size(), 0u);
+
+	for ( auto v : r )
+		Unref(v);
+
+	Unref(rt);
+	}
+
 broker::expected<broker::data> bro_broker::val_to_data(Val* v)
 	{
 	switch ( v->Type()->Tag() ) {
@@ -978,6 +1133,14 @@ broker::expected<broker::data> bro_broker::val_to_data(Val* v)
 		}
 	case TYPE_RECORD:
 		{
+		bool cacheable = data_cache.Cacheable(v->Type());
+
+		if ( cacheable )
+			{
+			if ( auto cached = data_cache.Lookup(v) )
+				return {*cached};
+			}
+
 		auto rec = v->AsRecordVal();
 		broker::vector rval;
 		size_t num_fields = v->Type()->AsRecordType()->NumFields();
@@ -1002,6 +1165,9 @@ broker::expected<broker::data> bro_broker::val_to_data(Val* v)
 			rval.emplace_back(move(*item));
 			}
 
+		if ( cacheable )
+			data_cache.Insert(v, rval);
+
 		return {std::move(rval)};
 		}
 	case TYPE_PATTERN:
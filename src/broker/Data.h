@@ -52,6 +52,20 @@ EnumVal* get_data_type(RecordVal* v, Frame* frame);
  */
 broker::expected<broker::data> val_to_data(Val* v);
 
+/**
+ * Set up caching the results of val_to_data() for values of record types
+ * that don't get modified once created.
+ * @param max_size the max number of values to cache, or zero to disable
+ * the cache.
+ * @param immutable_types the names of the cacheable record types.
+ */
+void init_data_cache(size_t max_size, TableVal* immutable_types);
+
+/**
+ * Drop all cached results of val_to_data().
+ */
+void clear_data_cache();
+
 /**
  * Convert a Broker data value to a Bro value.
  * @param d a Broker data value.
@@ -16,6 +16,7 @@
 #include "broker/messaging.bif.h"
 #include "broker/store.bif.h"
 #include "logging/Manager.h"
+#include "logging/WriterFrontend.h"
 #include "DebugLogger.h"
 #include "iosource/Manager.h"
 #include "SerializationFormat.h"
@@ -130,6 +131,13 @@ Manager::Manager(bool arg_reading_pcaps)
 	times_processed_without_idle = 0;
 	log_batch_size = 0;
 	log_batch_interval = 0;
+	event_batch_size = 0;
+	event_batch_interval = 0;
+	event_buffer.last_flush = 0;
+	event_buffer.message_count = 0;
+	processing_batch = false;
+	last_log_target.writer = nullptr;
+	last_log_target.valid = false;
 	log_topic_func = nullptr;
 	vector_of_data_type = nullptr;
 	log_id_type = nullptr;
@@ -148,6 +156,10 @@ void Manager::InitPostScript()
 
 	log_batch_size = get_option("Broker::log_batch_size")->AsCount();
 	log_batch_interval = get_option("Broker::log_batch_interval")->AsInterval();
+	event_batch_size = get_option("Broker::event_batch_size")->AsCount();
+	event_batch_interval = get_option("Broker::event_batch_interval")->AsInterval();
+	init_data_cache(get_option("Broker::data_cache_size")->AsCount(),
+	                get_option("Broker::immutable_types")->AsTableVal());
 	default_log_topic_prefix =
 	    get_option("Broker::default_log_topic_prefix")->AsString()->CheckString();
 	log_topic_func = get_option("Broker::log_topic")->AsFunc();
@@ -213,7 +225,9 @@ void Manager::InitPostScript()
 
 void Manager::Terminate()
 	{
+	FlushEventBuffer();
 	FlushLogBuffers();
+	clear_data_cache();
 
 	vector<string> stores_to_close;
 
@@ -251,6 +265,10 @@ void Manager::AdvanceTime(double seconds_since_unix_epoch)
 	if ( bstate->endpoint.is_shutdown() )
 		return;
 
+	if ( event_buffer.message_count &&
+	     network_time - event_buffer.last_flush >= event_batch_interval )
+		FlushEventBuffer();
+
 	if ( bstate->endpoint.use_real_time() )
 		return;
 
@@ -334,6 +352,7 @@ void Manager::Unpeer(const string& addr, uint16_t port)
 	DBG_LOG(DBG_BROKER, "Stopping to peer with %s:%" PRIu16,
 		addr.c_str(), port);
 
+	FlushEventBuffer();
 	FlushLogBuffers();
 	bstate->endpoint.unpeer_nosync(addr, port);
 	}
@@ -362,8 +381,21 @@ bool Manager::PublishEvent(string topic, std::string name, broker::vector args)
 	DBG_LOG(DBG_BROKER, "Publishing event: %s",
 		RenderEvent(topic, name, args).c_str());
 	broker::zeek::Event ev(std::move(name), std::move(args));
-	bstate->endpoint.publish(move(topic), ev.move_data());
-	++statistics.num_events_outgoing;
+
+	if ( event_batch_size <= 1 )
+		{
+		bstate->endpoint.publish(move(topic), ev.move_data());
+		++statistics.num_events_outgoing;
+		return true;
+		}
+
+	++event_buffer.message_count;
+	event_buffer.msgs[topic].emplace_back(ev.move_data());
+
+	if ( event_buffer.message_count >= event_batch_size ||
+	     (network_time - event_buffer.last_flush >= event_batch_interval ) )
+		FlushEventBuffer();
+
 	return true;
 	}
 
@@ -422,6 +454,9 @@ bool Manager::PublishIdentifier(std::string topic, std::string id)
 		return false;
 		}
 
+	// Keep the update ordered after events published before it.
+	FlushEventBuffer();
+
 	broker::zeek::IdentifierUpdate msg(move(id), move(*data));
 	DBG_LOG(DBG_BROKER, "Publishing id-update: %s",
 	        RenderMessage(topic, msg.as_data()).c_str());
@@ -581,7 +616,7 @@ bool Manager::PublishLogWrite(EnumVal* stream, EnumVal* writer, string path, int
 	return true;
 	}
 
-size_t Manager::LogBuffer::Flush(broker::endpoint& endpoint, size_t log_batch_size)
+size_t Manager::MessageBuffer::Flush(broker::endpoint& endpoint, size_t log_batch_size)
 	{
 	if ( endpoint.is_shutdown() )
 		return 0;
@@ -594,6 +629,10 @@ size_t Manager::LogBuffer::Flush(broker::endpoint& endpoint, size_t log_batch_si
 		{
 		auto& topic = kv.first;
 		auto& pending_batch = kv.second;
+
+		if ( pending_batch.empty() )
+			continue;
+
 		broker::vector batch;
 		batch.reserve(log_batch_size + 1);
 		pending_batch.swap(batch);
@@ -607,6 +646,13 @@ size_t Manager::LogBuffer::Flush(broker::endpoint& endpoint, size_t log_batch_si
 	return rval;
 	}
 
+size_t Manager::FlushEventBuffer()
+	{
+	auto rval = event_buffer.Flush(bstate->endpoint, event_batch_size);
+	statistics.num_events_outgoing += rval;
+	return rval;
+	}
+
 size_t Manager::FlushLogBuffers()
 	{
 	DBG_LOG(DBG_BROKER, "Flushing all log buffers");
@@ -868,9 +914,15 @@ void Manager::DispatchMessage(const broker::topic& topic, broker::data msg)
 			return;
 			}
 
+		// Writers may go away once scripts run, so any cached log
+		// target only stays valid for the current batch.
+		processing_batch = true;
+
 		for ( auto& i : batch.batch() )
 			DispatchMessage(topic, std::move(i));
 
+		processing_batch = false;
+		last_log_target.valid = false;
 		break;
 		}
 
@@ -1142,24 +1194,7 @@ bool bro_broker::Manager::ProcessLogWrite(broker::zeek::LogWrite lw)
 
 	++statistics.num_logs_incoming;
 	auto& stream_id_name = lw.stream_id().name;
-
-	// Get stream ID.
-	auto stream_id = data_to_val(std::move(lw.stream_id()), log_id_type);
-
-	if ( ! stream_id )
-		{
-		reporter->Warning("failed to unpack remote log stream id: %s",
-		                  stream_id_name.data());
-		return false;
-		}
-
-	// Get writer ID.
-	auto writer_id = data_to_val(std::move(lw.writer_id()), writer_id_type);
-	if ( ! writer_id )
-		{
-		reporter->Warning("failed to unpack remote log writer id for stream: %s", stream_id_name.data());
-		return false;
-		}
+	auto& writer_id_name = lw.writer_id().name;
 
 	auto path = caf::get_if<std::string>(&lw.path());
 
@@ -1177,6 +1212,51 @@ bool bro_broker::Manager::ProcessLogWrite(broker::zeek::LogWrite lw)
 		return false;
 		}
 
+	// Within a batch, consecutive writes usually go to the same writer,
+	// which then doesn't need to be looked up again.
+	logging::WriterFrontend* writer = nullptr;
+	auto& target = last_log_target;
+
+	if ( target.valid && target.stream_id == stream_id_name &&
+	     target.writer_id == writer_id_name && target.path == *path )
+		writer = target.writer;
+	else
+		{
+		// Get stream ID.
+		auto stream_id = data_to_val(lw.stream_id(), log_id_type);
+
+		if ( ! stream_id )
+			{
+			reporter->Warning("failed to unpack remote log stream id: %s",
+			                  stream_id_name.data());
+			return false;
+			}
+
+		// Get writer ID.
+		auto writer_id = data_to_val(lw.writer_id(), writer_id_type);
+		if ( ! writer_id )
+			{
+			reporter->Warning("failed to unpack remote log writer id for stream: %s", stream_id_name.data());
+			return false;
+			}
+
+		writer = log_mgr->FindRemoteWriter(stream_id->AsEnumVal(),
+		                                   writer_id->AsEnumVal(), *path);
+
+		if ( processing_batch )
+			{
+			target.stream_id = stream_id_name;
+			target.writer_id = writer_id_name;
+			target.path = *path;
+			target.writer = writer;
+			target.valid = true;
+			}
+		}
+
+	if ( ! writer )
+		// Unknown or disabled stream, so the write gets dropped.
+		return true;
+
 	BinarySerializationFormat fmt;
 	fmt.StartRead(serial_data->data(), serial_data->size());
 
@@ -1189,26 +1269,22 @@ bool bro_broker::Manager::ProcessLogWrite(broker::zeek::LogWrite lw)
 		return false;
 		}
 
-	auto vals = new threading::Value* [num_fields];
+	// Decode straight into a single block of values that the writer
+	// takes ownership of.
+	auto vals = threading::Value::NewVals(num_fields);
 
 	for ( int i = 0; i < num_fields; ++i )
 		{
-		vals[i] = new threading::Value;
-
 		if ( ! vals[i]->Read(&fmt) )
 			{
-			for ( int j = 0; j <=i; ++j )
-				delete vals[j];
-
-			delete [] vals;
+			threading::Value::DeleteVals(num_fields, vals);
 			reporter->Warning("failed to unserialize remote log field %d for stream: %s", i, stream_id_name.data());
 
 			return false;
 			}
 		}
 
-	log_mgr->WriteFromRemote(stream_id->AsEnumVal(), writer_id->AsEnumVal(),
-	                         std::move(*path), num_fields, vals);
+	writer->Write(num_fields, vals);
 	fmt.EndRead();
 	return true;
 	}
@@ -315,6 +315,12 @@ public:
 	 */
 	size_t FlushLogBuffers();
 
+	/**
+	 * Send all pending batched event messages.
+	 * @return the number of messages sent.
+	 */
+	size_t FlushEventBuffer();
+
 	/**
 	 * @return communication statistics.
 	 */
@@ -356,7 +362,8 @@ private:
 	const char* Tag() override
 		{ return "Broker::Manager"; }
 
-	struct LogBuffer {
+	// Messages waiting to be sent out in batches.
+	struct MessageBuffer {
 		// Indexed by topic string.
 		std::unordered_map<std::string, broker::vector> msgs;
 		double last_flush;
@@ -378,7 +385,19 @@ private:
 			}
 	};
 
-	std::vector<LogBuffer> log_buffers; // Indexed by stream ID enum.
+	// The writer that the last remote log write went to.
+	struct LogTarget {
+		std::string stream_id;
+		std::string writer_id;
+		std::string path;
+		logging::WriterFrontend* writer;
+		bool valid;
+	};
+
+	std::vector<MessageBuffer> log_buffers; // Indexed by stream ID enum.
+	MessageBuffer event_buffer;
+	LogTarget last_log_target;
+	bool processing_batch;
 	std::string default_log_topic_prefix;
 	std::shared_ptr<BrokerState> bstate;
 	std::unordered_map<std::string, StoreHandleVal*> data_stores;
@@ -396,6 +415,8 @@ private:
 
 	size_t log_batch_size;
 	double log_batch_interval;
+	size_t event_batch_size;
+	double event_batch_interval;
 	Func* log_topic_func;
 	VectorType* vector_of_data_type;
 	EnumType* log_id_type;
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <algorithm>
+#include <string.h>
 
 #include "File.h"
 #include "FileTimer.h"
@@ -85,7 +86,7 @@ File::File(const string& file_id, const string& source_name, Connection* conn,
 	: id(file_id), val(0), file_reassembler(0), stream_offset(0),
 	  reassembly_max_buffer(0), did_metadata_inference(false),
 	  reassembly_enabled(false), postpone_timeout(false), done(false),
-	  analyzers(this)
+	  analyzers(this), magic_state(0), magic_len(0), magic_final(false)
 	{
 	StaticInit();
 
@@ -109,6 +110,7 @@ File::~File()
 	DBG_LOG(DBG_FILE_ANALYSIS, "[%s] Destroying File object", id.c_str());
 	Unref(val);
 	delete file_reassembler;
+	delete magic_state;
 
 	for ( auto a : done_analyzers )
 		delete a;
@@ -317,24 +319,39 @@ void File::InferMetadata()
 
 	Val* bof_buffer_val = val->Lookup(bof_buffer_idx);
 
-	if ( ! bof_buffer_val )
+	if ( ! bof_buffer_val && bof_buffer.size > 0 )
 		{
-		if ( bof_buffer.size == 0 )
-			return;
-
-		BroString* bs = concatenate(bof_buffer.chunks);
-		bof_buffer_val = new StringVal(bs);
-		val->Assign(bof_buffer_idx, bof_buffer_val);
+		bof_buffer_val = BOFVal();
+		val->Assign(bof_buffer_idx, bof_buffer_val->Ref());
 		}
 
-	if ( ! FileEventAvailable(file_sniff) )
+	if ( ! bof_buffer_val || ! FileEventAvailable(file_sniff) )
+		{
+		delete magic_state;
+		magic_state = 0;
 		return;
+		}
 
 	RuleMatcher::MIME_Matches matches;
 	const u_char* data = bof_buffer_val->AsString()->Bytes();
 	uint64_t len = bof_buffer_val->AsString()->Len();
 	len = min(len, LookupFieldDefaultCount(bof_buffer_size_idx));
-	file_mgr->DetectMIME(data, len, &matches);
+
+	// The signatures have usually seen the data already while it was
+	// buffered.  That's not the case if a script changed the buffer or
+	// its size in the meantime, so then match on the buffer as a whole.
+	bool have_magic = magic_state && bof_buffer_val == bof_buffer.val &&
+	                  magic_len > 0 &&
+	                  (magic_final ? magic_len <= len : magic_len == len);
+
+	if ( have_magic )
+		matches.swap(magic_matches);
+	else
+		file_mgr->DetectMIME(data, len, &matches);
+
+	delete magic_state;
+	magic_state = 0;
+	magic_matches.clear();
 
 	RecordVal* meta = new RecordVal(fa_metadata_type);
 
@@ -357,21 +374,83 @@ bool File::BufferBOF(const u_char* data, uint64_t len)
 
 	uint64_t desired_size = LookupFieldDefaultCount(bof_buffer_size_idx);
 
-	bof_buffer.chunks.push_back(new BroString(data, len, 0));
+	// The chunks are kept in one buffer that later becomes the contents
+	// of the "bof_buffer" field without another copy, with room for the
+	// terminating NUL that its string gets.
+	if ( bof_buffer.size + len + 1 > bof_buffer.capacity )
+		{
+		uint64_t capacity = max(desired_size, bof_buffer.size + len) + 1;
+		u_char* buf = new u_char[capacity];
+
+		if ( bof_buffer.size > 0 )
+			memcpy(buf, bof_buffer.data, bof_buffer.size);
+
+		delete [] bof_buffer.data;
+		bof_buffer.data = buf;
+		bof_buffer.capacity = capacity;
+		}
+
+	memcpy(bof_buffer.data + bof_buffer.size, data, len);
 	bof_buffer.size += len;
+	bof_buffer.chunks.push_back(len);
+
+	MatchMagic(data, len, desired_size);
 
-	if ( bof_buffer.size < desired_size )
+	// Stop buffering early if requested and no further data can change
+	// the outcome of the file magic signatures.
+	bool sniffed = BifConst::Files::early_sniff && magic_state && magic_final;
+
+	if ( bof_buffer.size < desired_size && ! sniffed )
 		return true;
 
 	bof_buffer.full = true;
 
 	if ( bof_buffer.size > 0 )
+		val->Assign(bof_buffer_idx, BOFVal()->Ref());
+
+	return false;
+	}
+
+void File::MatchMagic(const u_char* data, uint64_t len, uint64_t desired_size)
+	{
+	if ( magic_final )
+		return;
+
+	if ( ! magic_state )
 		{
-		BroString* bs = concatenate(bof_buffer.chunks);
-		val->Assign(bof_buffer_idx, new StringVal(bs));
+		// Matching has to start with the first chunk, or not at all.
+		if ( ! rule_matcher || did_metadata_inference ||
+		     bof_buffer.chunks.size() > 1 ||
+		     ! FileEventAvailable(file_sniff) )
+			{
+			magic_final = true;
+			return;
+			}
+
+		magic_state = rule_matcher->InitFileMagic();
 		}
 
-	return false;
+	uint64_t n = desired_size > magic_len ? min(len, desired_size - magic_len) : 0;
+
+	if ( n == 0 )
+		return;
+
+	if ( ! rule_matcher->MatchIncremental(magic_state, data, n, &magic_matches) )
+		magic_final = true;
+
+	magic_len += n;
+	}
+
+StringVal* File::BOFVal()
+	{
+	if ( ! bof_buffer.val && bof_buffer.size > 0 )
+		{
+		bof_buffer.data[bof_buffer.size] = '\0';
+		bof_buffer.val = new StringVal(new BroString(1, bof_buffer.data,
+		                                             bof_buffer.size));
+		}
+
+	return bof_buffer.val;
 	}
 
 void File::DeliverStream(const u_char* data, uint64_t len)
@@ -414,15 +493,15 @@ void File::DeliverStream(const u_char* data, uint64_t len)
 				{
 				if ( ! a->Skipping() )
 					{
-					if ( ! a->DeliverStream(bof_buffer.chunks[i]->Bytes(),
-								bof_buffer.chunks[i]->Len()) )
+					if ( ! a->DeliverStream(bof_buffer.data + bytes_delivered,
+								bof_buffer.chunks[i]) )
 						{
 						a->SetSkip(true);
 						analyzers.QueueRemove(a->Tag(), a->Args());
 						}
 					}
 
-				bytes_delivered += bof_buffer.chunks[i]->Len();
+				bytes_delivered += bof_buffer.chunks[i];
 				}
 
 			a->SetGotStreamDelivery();
@@ -12,6 +12,7 @@
 #include "Tag.h"
 #include "AnalyzerSet.h"
 #include "BroString.h"
+#include "RuleMatcher.h"
 #include "WeirdState.h"
 
 namespace file_analysis {
@@ -268,6 +269,22 @@ protected:
 	 */
 	bool BufferBOF(const u_char* data, uint64_t len);
 
+	/**
+	 * Feeds data at the beginning of a file to the file magic signatures,
+	 * so that their results are available as soon as the BOF buffer is
+	 * full.
+	 * @param data pointer to a data chunk just added to the BOF buffer.
+	 * @param len number of bytes in the data chunk.
+	 * @param desired_size the number of bytes to match signatures on.
+	 */
+	void MatchMagic(const u_char* data, uint64_t len, uint64_t desired_size);
+
+	/**
+	 * @return the contents of the BOF buffer as a value shared with the
+	 * "bof_buffer" field of #val, or a null pointer if it's empty.
+	 */
+	StringVal* BOFVal();
+
 	/**
 	 * Does metadata inference (e.g. mime type detection via file
 	 * magic signatures) using data in the BOF (beginning-of-file) buffer
@@ -329,15 +346,28 @@ protected:
 	std::list<Analyzer *> done_analyzers; /**< Analyzers we're done with, remembered here until they can be safely deleted. */
 
 	struct BOF_Buffer {
-		BOF_Buffer() : full(false), size(0) {}
+		BOF_Buffer() : full(false), size(0), capacity(0), data(0), val(0) {}
 		~BOF_Buffer()
-			{ for ( size_t i = 0; i < chunks.size(); ++i ) delete chunks[i]; }
+			{
+			if ( val )
+				Unref(val);
+			else
+				delete [] data;
+			}
 
 		bool full;
 		uint64_t size;
-		BroString::CVec chunks;
+		uint64_t capacity;
+		u_char* data;            /**< Owned by #val once that exists. */
+		StringVal* val;
+		std::vector<uint64_t> chunks;  /**< Lengths of buffered chunks. */
 	} bof_buffer;              /**< Beginning of file buffer. */
 
+	RuleFileMagicState* magic_state;   /**< File magic matching state for the BOF buffer. */
+	RuleMatcher::MIME_Matches magic_matches;  /**< File magic matches so far. */
+	uint64_t magic_len;        /**< Number of bytes matched against file magic. */
+	bool magic_final;          /**< Whether more data can't change #magic_matches. */
+
 	WeirdStateMap weird_state;
 
 	static int id_idx;
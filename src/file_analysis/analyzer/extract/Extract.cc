@@ -4,16 +4,19 @@
 #include <fcntl.h>
 
 #include "Extract.h"
+#include "ExtractWriter.h"
 #include "util.h"
 #include "Event.h"
 #include "file_analysis/Manager.h"
 
+#include "analyzer/extract/consts.bif.h"
+
 using namespace file_analysis;
 
 Extract::Extract(RecordVal* args, File* file, const string& arg_filename,
                  uint64_t arg_limit)
     : file_analysis::Analyzer(file_mgr->GetComponentTag("EXTRACT"), args, file),
-      filename(arg_filename), limit(arg_limit), depth(0)
+      filename(arg_filename), limit(arg_limit), depth(0), truncated(false)
 	{
 	fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0666);
 
@@ -28,10 +31,67 @@ Extract::Extract(RecordVal* args, File* file, const string& arg_filename,
 
 Extract::~Extract()
 	{
-	if ( fd )
+	if ( ! fd )
+		return;
+
+	if ( ExtractWriter* writer = ExtractWriter::Instance() )
+		writer->Close(fd);
+	else
 		safe_close(fd);
 	}
 
+bool Extract::Write(const char* data, uint64_t len)
+	{
+	ExtractWriter* writer = ExtractWriter::Instance();
+
+	if ( ! writer )
+		{
+		if ( data )
+			safe_write(fd, data, len);
+		else
+			{
+			char* tmp = new char[len]();
+			safe_write(fd, tmp, len);
+			delete [] tmp;
+			}
+
+		depth += len;
+		return true;
+		}
+
+	if ( writer->Write(fd, data, len, BifConst::FileExtract::async_wait_when_full) )
+		{
+		depth += len;
+		return true;
+		}
+
+	writer->Truncated();
+	truncated = true;
+
+	if ( file_extraction_truncated )
+		{
+		File* f = GetFile();
+		f->FileEvent(file_extraction_truncated, {
+			f->GetVal()->Ref(),
+			Args()->Ref(),
+			val_mgr->GetCount(depth),
+		});
+		}
+
+	return false;
+	}
+
+bool Extract::EndOfFile()
+	{
+	if ( ! fd )
+		return true;
+
+	if ( ExtractWriter* writer = ExtractWriter::Instance() )
+		writer->Flush(fd);
+
+	return true;
+	}
+
 static Val* get_extract_field_val(RecordVal* args, const char* name)
 	{
 	Val* rval = args->Lookup(name);
@@ -82,7 +142,7 @@ static bool check_limit_exceeded(uint64_t lim, uint64_t depth, uint64_t len, uin
 
 bool Extract::DeliverStream(const u_char* data, uint64_t len)
 	{
-	if ( ! fd )
+	if ( ! fd || truncated )
 		return false;
 
 	uint64_t towrite = 0;
@@ -102,24 +162,20 @@ bool Extract::DeliverStream(const u_char* data, uint64_t len)
 		limit_exceeded = check_limit_exceeded(limit, depth, len, &towrite);
 		}
 
-	if ( towrite > 0 )
-		{
-		safe_write(fd, reinterpret_cast<const char*>(data), towrite);
-		depth += towrite;
-		}
+	if ( towrite > 0 &&
+	     ! Write(reinterpret_cast<const char*>(data), towrite) )
+		return false;
 
 	return ( ! limit_exceeded );
 	}
 
 bool Extract::Undelivered(uint64_t offset, uint64_t len)
 	{
+	if ( ! fd || truncated )
+		return false;
+
 	if ( depth == offset )
-		{
-		char* tmp = new char[len]();
-		safe_write(fd, tmp, len);
-		delete [] tmp;
-		depth += len;
-		}
+		return Write(0, len);
 
 	return true;
 	}
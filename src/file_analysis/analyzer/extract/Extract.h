@@ -36,10 +36,19 @@ public:
 	 * Report undelivered bytes.
 	 * @param offset distance into the file where the gap occurred.
 	 * @param len number of bytes undelivered.
-	 * @return true
+	 * @return false if there was no extraction file open or the extracted
+	 *         file had to be truncated, else true.
 	 */
 	bool Undelivered(uint64_t offset, uint64_t len) override;
 
+	/**
+	 * Waits for the background writer, if there is one, to write out
+	 * everything queued for the extracted file, so that the file is
+	 * complete on disk once :zeek:see:`file_state_remove` is raised.
+	 * @return true
+	 */
+	bool EndOfFile() override;
+
 	/**
 	 * Create a new instance of an Extract analyzer.
 	 * @param args the \c AnalyzerArgs value which represents the analyzer.
@@ -70,10 +79,21 @@ protected:
 	        uint64_t arg_limit);
 
 private:
+	/**
+	 * Writes data to the extraction file, through the background writer
+	 * if there is one.
+	 * @param data the data, or a null pointer to write zeros.
+	 * @param len the number of bytes to write.
+	 * @return false if the background writer's queue was full and the
+	 *         extracted file got truncated, else true.
+	 */
+	bool Write(const char* data, uint64_t len);
+
 	string filename;
 	int fd;
 	uint64_t limit;
 	uint64_t depth;
+	bool truncated;
 };
 
 } // namespace file_analysis
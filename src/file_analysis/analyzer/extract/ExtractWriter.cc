@@ -0,0 +1,171 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek-config.h"
+
+#include <string.h>
+
+#include "ExtractWriter.h"
+#include "util.h"
+
+#include "analyzer/extract/consts.bif.h"
+
+using namespace file_analysis;
+
+ExtractWriter* ExtractWriter::instance = 0;
+bool ExtractWriter::shut_down = false;
+
+ExtractWriter::ExtractWriter(uint64_t arg_max_bytes, uint64_t arg_coalesce_size)
+	: done(false), max_bytes(arg_max_bytes), coalesce_size(arg_coalesce_size)
+	{
+	memset(&stats, 0, sizeof(stats));
+	thread = std::thread(&ExtractWriter::Run, this);
+	}
+
+ExtractWriter::~ExtractWriter()
+	{
+		{
+		std::lock_guard<std::mutex> lock(mutex);
+		done = true;
+		}
+
+	has_work.notify_one();
+	thread.join();
+	}
+
+bool ExtractWriter::Write(int fd, const char* data, uint64_t len, bool wait)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// A chunk larger than the whole queue is accepted once the queue has
+	// drained, so that it can't stall forever.
+	auto fits = [&]()
+		{
+		return stats.queued_bytes == 0 ||
+		       stats.queued_bytes + len <= max_bytes;
+		};
+
+	if ( ! fits() )
+		{
+		if ( ! wait )
+			return false;
+
+		++stats.waits;
+		has_space.wait(lock, fits);
+		}
+
+	// The writer thread only ever works on the front job, so the last one
+	// is safe to extend as long as it's queued behind others.
+	bool append = jobs.size() > 1 && jobs.back().fd == fd &&
+		! jobs.back().close &&
+		jobs.back().data.size() + len <= coalesce_size;
+
+	if ( append )
+		++stats.coalesced;
+	else
+		jobs.push_back(Job{fd, false, std::string()});
+
+	std::string& buf = jobs.back().data;
+
+	if ( data )
+		buf.append(data, len);
+	else
+		buf.append(len, '\0');
+
+	stats.queued_bytes += len;
+
+	if ( stats.queued_bytes > stats.max_queued_bytes )
+		stats.max_queued_bytes = stats.queued_bytes;
+
+	lock.unlock();
+	has_work.notify_one();
+	return true;
+	}
+
+void ExtractWriter::Flush(int fd)
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// Jobs stay queued until they're done, and the file descriptor can't
+	// get reused before its close job has run.
+	has_space.wait(lock, [&]()
+		{
+		for ( const auto& job : jobs )
+			if ( job.fd == fd )
+				return false;
+
+		return true;
+		});
+	}
+
+void ExtractWriter::Close(int fd)
+	{
+		{
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(Job{fd, true, std::string()});
+		}
+
+	has_work.notify_one();
+	}
+
+void ExtractWriter::Truncated()
+	{
+	std::lock_guard<std::mutex> lock(mutex);
+	++stats.truncated;
+	}
+
+ExtractWriter::Stats ExtractWriter::GetStats()
+	{
+	std::lock_guard<std::mutex> lock(mutex);
+	return stats;
+	}
+
+void ExtractWriter::Run()
+	{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	for ( ; ; )
+		{
+		has_work.wait(lock, [this]() { return done || ! jobs.empty(); });
+
+		if ( jobs.empty() )
+			break;
+
+		// Keep the job in the queue while writing so that Write()
+		// doesn't coalesce into it, and account for its bytes only
+		// once they're on disk.
+		Job& job = jobs.front();
+		lock.unlock();
+
+		if ( job.close )
+			safe_close(job.fd);
+		else
+			safe_write(job.fd, job.data.data(), job.data.size());
+
+		lock.lock();
+
+		if ( ! job.close )
+			{
+			++stats.writes;
+			stats.queued_bytes -= job.data.size();
+			}
+
+		jobs.pop_front();
+		has_space.notify_all();
+		}
+	}
+
+ExtractWriter* ExtractWriter::Instance()
+	{
+	if ( ! instance && ! shut_down && BifConst::FileExtract::async_queue_size > 0 )
+		instance = new ExtractWriter(BifConst::FileExtract::async_queue_size,
+		                             BifConst::FileExtract::async_coalesce_size);
+
+	return instance;
+	}
+
+void ExtractWriter::Shutdown()
+	{
+	delete instance;
+	instance = 0;
+	shut_down = true;
+	}
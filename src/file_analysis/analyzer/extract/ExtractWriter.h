@@ -0,0 +1,114 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace file_analysis {
+
+/**
+ * A background thread that writes extracted file content to disk, so that
+ * the main thread doesn't block on file system I/O.  Data is buffered in a
+ * queue bounded by a total number of bytes.  Consecutive chunks for the
+ * same file are merged into larger sequential writes.
+ */
+class ExtractWriter {
+public:
+	struct Stats {
+		uint64_t queued_bytes;
+		uint64_t max_queued_bytes;
+		uint64_t writes;
+		uint64_t coalesced;
+		uint64_t waits;
+		uint64_t truncated;
+	};
+
+	/**
+	 * Constructor.  Starts the writer thread.
+	 * @param max_bytes the maximum number of bytes to buffer.
+	 * @param coalesce_size the maximum size of a merged write.
+	 */
+	ExtractWriter(uint64_t max_bytes, uint64_t coalesce_size);
+
+	/**
+	 * Destructor.  Writes out all pending data, closes all pending
+	 * files, and stops the thread.
+	 */
+	~ExtractWriter();
+
+	/**
+	 * Queues data for writing to a file.
+	 * @param fd the file descriptor to write to.
+	 * @param data the data, or a null pointer to write zeros.
+	 * @param len the number of bytes to write.
+	 * @param wait if true and the queue doesn't have space for the data,
+	 *        blocks until it does.
+	 * @return false if the data didn't fit into the queue and \a wait was
+	 *         false, else true.
+	 */
+	bool Write(int fd, const char* data, uint64_t len, bool wait);
+
+	/**
+	 * Blocks until all data queued for a file has been written.
+	 * @param fd the file descriptor to wait for.
+	 */
+	void Flush(int fd);
+
+	/**
+	 * Queues closing a file once all data queued for it has been written.
+	 * @param fd the file descriptor to close.
+	 */
+	void Close(int fd);
+
+	/**
+	 * Records that a file was truncated because the queue was full.
+	 */
+	void Truncated();
+
+	/**
+	 * @return a snapshot of the writer's statistics.
+	 */
+	Stats GetStats();
+
+	/**
+	 * @return the global writer instance, creating it on first use, or a
+	 *         null pointer if :zeek:see:`FileExtract::async_queue_size` is
+	 *         zero or the writer has already been shut down.
+	 */
+	static ExtractWriter* Instance();
+
+	/**
+	 * Flushes and deletes the global writer instance, if there is one.
+	 * Extraction continues synchronously afterwards.
+	 */
+	static void Shutdown();
+
+private:
+	struct Job {
+		int fd;
+		bool close;
+		std::string data;
+	};
+
+	void Run();
+
+	std::deque<Job> jobs;
+	std::mutex mutex;
+	std::condition_variable has_work;
+	std::condition_variable has_space;
+	std::thread thread;
+	bool done;
+
+	uint64_t max_bytes;
+	uint64_t coalesce_size;
+	Stats stats;
+
+	static ExtractWriter* instance;
+	static bool shut_down;
+};
+
+} // namespace file_analysis
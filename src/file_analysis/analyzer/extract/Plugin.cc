@@ -3,6 +3,7 @@
 #include "plugin/Plugin.h"
 
 #include "Extract.h"
+#include "ExtractWriter.h"
 
 namespace plugin {
 namespace Zeek_FileExtract {
@@ -18,6 +19,12 @@ public:
 		config.description = "Extract file content";
 		return config;
 		}
+
+	void Done()
+		{
+		plugin::Plugin::Done();
+		::file_analysis::ExtractWriter::Shutdown();
+		}
 } plugin;
 
 }
@@ -0,0 +1,269 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#include "zeek-config.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "MultiHash.h"
+#include "Event.h"
+#include "file_analysis/Manager.h"
+
+#include "analyzer/hash/consts.bif.h"
+
+using namespace file_analysis;
+
+static const struct {
+	const char* name;
+	HashAlgorithm alg;
+} hash_kinds[] = {
+	{ "md5", Hash_MD5 },
+	{ "sha1", Hash_SHA1 },
+	{ "sha256", Hash_SHA256 },
+};
+
+static const int num_hash_kinds = sizeof(hash_kinds) / sizeof(hash_kinds[0]);
+
+static_assert(num_hash_kinds == MultiHash::NUM_HASH_KINDS,
+              "MultiHash::State must have a context per hash kind");
+
+// Large chunks are fed to the digests piecewise, so that each piece stays
+// in the cache while all of the digests consume it.
+static const uint64_t hash_block_size = 16384;
+
+static void update_digests(MultiHash::State* s, const u_char* data, uint64_t len)
+	{
+	while ( len > 0 )
+		{
+		uint64_t n = std::min(len, hash_block_size);
+
+		for ( int i = 0; i < num_hash_kinds; ++i )
+			{
+			if ( s->ctx[i] && ! EVP_DigestUpdate(s->ctx[i], data, n) )
+				s->failed = true;
+			}
+
+		data += n;
+		len -= n;
+		}
+	}
+
+namespace {
+
+// A thread computing the digests of all MultiHash analyzers.  It processes
+// chunks in order, so the digests of each file see their data in sequence.
+class HashWorker {
+public:
+	explicit HashWorker(uint64_t arg_max_bytes)
+		: done(false), queued_bytes(0), max_bytes(arg_max_bytes)
+		{
+		thread = std::thread(&HashWorker::Run, this);
+		}
+
+	~HashWorker()
+		{
+			{
+			std::lock_guard<std::mutex> lock(mutex);
+			done = true;
+			}
+
+		has_work.notify_one();
+		thread.join();
+		}
+
+	// Queues a copy of the data, blocking while the queue is full.
+	void Feed(MultiHash::State* s, const u_char* data, uint64_t len)
+		{
+		std::unique_lock<std::mutex> lock(mutex);
+		progress.wait(lock, [&]()
+			{
+			return queued_bytes == 0 || queued_bytes + len <= max_bytes;
+			});
+
+		jobs.push_back(Job{s, std::string(reinterpret_cast<const char*>(data), len)});
+		++s->pending;
+		queued_bytes += len;
+		lock.unlock();
+		has_work.notify_one();
+		}
+
+	// Blocks until all chunks queued for the state have been hashed.
+	void Wait(MultiHash::State* s)
+		{
+		std::unique_lock<std::mutex> lock(mutex);
+		progress.wait(lock, [s]() { return s->pending == 0; });
+		}
+
+private:
+	struct Job {
+		MultiHash::State* state;
+		std::string data;
+	};
+
+	void Run()
+		{
+		std::unique_lock<std::mutex> lock(mutex);
+
+		for ( ; ; )
+			{
+			has_work.wait(lock, [this]() { return done || ! jobs.empty(); });
+
+			if ( jobs.empty() )
+				break;
+
+			Job job = std::move(jobs.front());
+			jobs.pop_front();
+			lock.unlock();
+
+			update_digests(job.state,
+			               reinterpret_cast<const u_char*>(job.data.data()),
+			               job.data.size());
+
+			lock.lock();
+			queued_bytes -= job.data.size();
+			--job.state->pending;
+			progress.notify_all();
+			}
+		}
+
+	std::deque<Job> jobs;
+	std::mutex mutex;
+	std::condition_variable has_work;
+	std::condition_variable progress;
+	std::thread thread;
+	bool done;
+	uint64_t queued_bytes;
+	uint64_t max_bytes;
+};
+
+}
+
+static HashWorker* hash_worker = 0;
+static bool hash_worker_shut_down = false;
+
+static HashWorker* get_hash_worker()
+	{
+	if ( ! hash_worker && ! hash_worker_shut_down &&
+	     BifConst::FileHash::multi_hash_queue_size > 0 )
+		hash_worker = new HashWorker(BifConst::FileHash::multi_hash_queue_size);
+
+	return hash_worker;
+	}
+
+MultiHash::MultiHash(RecordVal* args, File* file)
+	: file_analysis::Analyzer(file_mgr->GetComponentTag("MULTIHASH"), args, file),
+	  fed(false), done(false)
+	{
+	TableVal* kinds = BifConst::FileHash::multi_hash_kinds->AsTableVal();
+
+	state.pending = 0;
+	state.failed = false;
+
+	for ( int i = 0; i < num_hash_kinds; ++i )
+		{
+		StringVal* name = new StringVal(hash_kinds[i].name);
+		state.ctx[i] = kinds->Lookup(name, false) ?
+			hash_init(hash_kinds[i].alg) : 0;
+		Unref(name);
+		}
+	}
+
+MultiHash::~MultiHash()
+	{
+	Discard();
+	}
+
+void MultiHash::Shutdown()
+	{
+	delete hash_worker;
+	hash_worker = 0;
+	hash_worker_shut_down = true;
+	}
+
+void MultiHash::WaitPending()
+	{
+	// Chunks can only be pending if the worker exists, and it finishes
+	// its queue before shutting down.  Looking it up via
+	// get_hash_worker() here could start it, e.g. from the destructor.
+	if ( hash_worker )
+		hash_worker->Wait(&state);
+	}
+
+void MultiHash::Discard()
+	{
+	WaitPending();
+
+	for ( int i = 0; i < num_hash_kinds; ++i )
+		{
+		if ( state.ctx[i] )
+			EVP_MD_CTX_free(state.ctx[i]);
+
+		state.ctx[i] = 0;
+		}
+
+	done = true;
+	}
+
+bool MultiHash::DeliverStream(const u_char* data, uint64_t len)
+	{
+	if ( done )
+		return false;
+
+	if ( len == 0 )
+		return true;
+
+	fed = true;
+
+	if ( HashWorker* worker = get_hash_worker() )
+		worker->Feed(&state, data, len);
+	else
+		update_digests(&state, data, len);
+
+	return true;
+	}
+
+bool MultiHash::EndOfFile()
+	{
+	if ( done )
+		return false;
+
+	WaitPending();
+
+	if ( ! fed || state.failed )
+		{
+		Discard();
+		return false;
+		}
+
+	for ( int i = 0; i < num_hash_kinds; ++i )
+		{
+		if ( ! state.ctx[i] )
+			continue;
+
+		u_char digest[EVP_MAX_MD_SIZE];
+		unsigned int n = 0;
+
+		if ( EVP_DigestFinal(state.ctx[i], digest, &n) )
+			mgr.QueueEventFast(file_hash, {
+				GetFile()->GetVal()->Ref(),
+				new StringVal(hash_kinds[i].name),
+				new StringVal(digest_print(digest, n)),
+			});
+
+		EVP_MD_CTX_free(state.ctx[i]);
+		state.ctx[i] = 0;
+		}
+
+	done = true;
+	return false;
+	}
+
+bool MultiHash::Undelivered(uint64_t offset, uint64_t len)
+	{
+	Discard();
+	return false;
+	}
@@ -0,0 +1,107 @@
+// See the file "COPYING" in the main distribution directory for copyright.
+
+#pragma once
+
+#include "digest.h"
+#include "File.h"
+#include "Analyzer.h"
+
+#include "events.bif.h"
+
+namespace file_analysis {
+
+/**
+ * An analyzer that computes several digests of file contents in a single
+ * pass over the data, optionally on a background thread.  The digests are
+ * selected by :zeek:see:`FileHash::multi_hash_kinds` and reported through
+ * "file_hash" events just like the individual hash analyzers do.
+ */
+class MultiHash : public file_analysis::Analyzer {
+public:
+
+	/**
+	 * The number of digest kinds the analyzer supports (MD5, SHA1 and
+	 * SHA256).
+	 */
+	static constexpr int NUM_HASH_KINDS = 3;
+
+	/**
+	 * The running state of all digests of one file.  When hashing on
+	 * a background thread, the thread owns it while chunks are pending.
+	 */
+	struct State {
+		EVP_MD_CTX* ctx[NUM_HASH_KINDS];
+		int pending;
+		bool failed;
+	};
+
+	/**
+	 * Destructor.
+	 */
+	~MultiHash() override;
+
+	/**
+	 * Feeds the next chunk of file contents to all digests.
+	 * @param data pointer to start of a chunk of a file data.
+	 * @param len number of bytes in the data chunk.
+	 * @return false if the digests are in an invalid state, else true.
+	 */
+	bool DeliverStream(const u_char* data, uint64_t len) override;
+
+	/**
+	 * Finalizes the digests and raises a "file_hash" event for each.
+	 * @return always false so analyzer will be detached from file.
+	 */
+	bool EndOfFile() override;
+
+	/**
+	 * Missing data can't be handled, so the digests won't be finalized.
+	 * @param offset byte offset in file at which missing chunk starts.
+	 * @param len number of missing bytes.
+	 * @return always false so analyzer will detach from file.
+	 */
+	bool Undelivered(uint64_t offset, uint64_t len) override;
+
+	/**
+	 * Create a new instance of the multi-hash file analyzer.
+	 * @param args the \c AnalyzerArgs value which represents the analyzer.
+	 * @param file the file to which the analyzer will be attached.
+	 * @return the new analyzer instance or a null pointer if there's no
+	 *         handler for the "file_hash" event.
+	 */
+	static file_analysis::Analyzer* Instantiate(RecordVal* args, File* file)
+		{ return file_hash ? new MultiHash(args, file) : 0; }
+
+	/**
+	 * Stops the background hashing thread, if one is running.
+	 */
+	static void Shutdown();
+
+protected:
+
+	/**
+	 * Constructor.
+	 * @param args the \c AnalyzerArgs value which represents the analyzer.
+	 * @param file the file to which the analyzer will be attached.
+	 */
+	MultiHash(RecordVal* args, File* file);
+
+private:
+	/**
+	 * Waits for pending chunks, if any, and frees the digest contexts
+	 * without reporting results.
+	 */
+	void Discard();
+
+	/**
+	 * Blocks until the background thread has hashed all chunks queued
+	 * for this file.  Never starts the thread.
+	 */
+	void WaitPending();
+
+	State state;
+	bool fed;
+	bool done;
+};
+
+} // namespace file_analysis
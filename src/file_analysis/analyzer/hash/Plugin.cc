@@ -3,6 +3,7 @@
 #include "plugin/Plugin.h"
 
 #include "Hash.h"
+#include "MultiHash.h"
 
 namespace plugin {
 namespace Zeek_FileHash {
@@ -14,12 +15,19 @@ public:
 		AddComponent(new ::file_analysis::Component("MD5", ::file_analysis::MD5::Instantiate));
 		AddComponent(new ::file_analysis::Component("SHA1", ::file_analysis::SHA1::Instantiate));
 		AddComponent(new ::file_analysis::Component("SHA256", ::file_analysis::SHA256::Instantiate));
+		AddComponent(new ::file_analysis::Component("MULTIHASH", ::file_analysis::MultiHash::Instantiate));
 
 		plugin::Configuration config;
 		config.name = "Zeek::FileHash";
 		config.description = "Hash file content";
 		return config;
 		}
+
+	void Done()
+		{
+		plugin::Plugin::Done();
+		::file_analysis::MultiHash::Shutdown();
+		}
 } plugin;
 
 }
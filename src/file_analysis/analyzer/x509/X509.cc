@@ -1,12 +1,16 @@
 // See the file "COPYING" in the main distribution directory for copyright.
 
+#include <list>
 #include <string>
+#include <unordered_map>
 
 #include "X509.h"
 #include "Event.h"
+#include "Var.h"
 
 #include "events.bif.h"
 #include "types.bif.h"
+#include "consts.bif.h"
 
 #include "file_analysis/Manager.h"
 
@@ -20,6 +24,22 @@
 
 using namespace file_analysis;
 
+namespace {
+
+struct CachedCert {
+	X509Val* cert_val;
+	RecordVal* cert_record;
+	std::list<const std::string*>::iterator lru_pos;
+};
+
+}
+
+// Parsed certificates, keyed by their DER encoding.  The list orders the
+// keys from most to least recently used.
+static std::unordered_map<std::string, CachedCert> cert_cache;
+static std::list<const std::string*> cert_cache_lru;
+static file_analysis::X509::CacheStats cert_cache_stats;
+
 file_analysis::X509::X509(RecordVal* args, file_analysis::File* file)
 	: file_analysis::X509Common::X509Common(file_mgr->GetComponentTag("X509"), args, file)
 	{
@@ -40,21 +60,37 @@ bool file_analysis::X509::Undelivered(uint64_t offset, uint64_t len)
 
 bool file_analysis::X509::EndOfFile()
 	{
-	// ok, now we can try to parse the certificate with openssl. Should
-	// be rather straightforward...
-	const unsigned char* cert_char = reinterpret_cast<const unsigned char*>(cert_data.data());
+	X509Val* cert_val = 0;
+	RecordVal* cert_record = 0;
+	bool use_cache = BifConst::X509::certificate_cache_size > 0 && ! SkipCache();
 
-	::X509* ssl_cert = d2i_X509(NULL, &cert_char, cert_data.size());
-	if ( ! ssl_cert )
+	if ( ! use_cache || ! LookupCache(&cert_val, &cert_record) )
 		{
-		reporter->Weird(GetFile(), "x509_cert_parse_error");
-		return false;
-		}
+		// ok, now we can try to parse the certificate with openssl. Should
+		// be rather straightforward...
+		const unsigned char* cert_char = reinterpret_cast<const unsigned char*>(cert_data.data());
 
-	X509Val* cert_val = new X509Val(ssl_cert); // cert_val takes ownership of ssl_cert
+		::X509* ssl_cert = d2i_X509(NULL, &cert_char, cert_data.size());
+		if ( ! ssl_cert )
+			{
+			reporter->Weird(GetFile(), "x509_cert_parse_error");
+			return false;
+			}
+
+		cert_val = new X509Val(ssl_cert); // cert_val takes ownership of ssl_cert
+
+		// parse basic information into record.
+		uint64_t weirds = reporter->GetWeirdCount();
+		cert_record = ParseCertificate(cert_val, GetFile());
 
-	// parse basic information into record.
-	RecordVal* cert_record = ParseCertificate(cert_val, GetFile());
+		// Weirds are raised per file while parsing, and a cache hit
+		// would skip them.  So certificates producing any aren't
+		// cached, and every file using them reports them again.
+		if ( use_cache && reporter->GetWeirdCount() == weirds )
+			InsertCache(cert_val, cert_record);
+		}
+
+	::X509* ssl_cert = cert_val->GetCertificate();
 
 	// and send the record on to scriptland
 	mgr.QueueEvent(x509_certificate, {
@@ -86,6 +122,89 @@ bool file_analysis::X509::EndOfFile()
 	return false;
 	}
 
+bool file_analysis::X509::LookupCache(X509Val** cert_val, RecordVal** cert_record)
+	{
+	auto it = cert_cache.find(cert_data);
+
+	if ( it == cert_cache.end() )
+		{
+		++cert_cache_stats.misses;
+		return false;
+		}
+
+	++cert_cache_stats.hits;
+	cert_cache_lru.splice(cert_cache_lru.begin(), cert_cache_lru, it->second.lru_pos);
+
+	// The X509Val is immutable, but scripts may modify the record, so
+	// every file gets its own copy of it.
+	*cert_val = it->second.cert_val;
+	(*cert_val)->Ref();
+	*cert_record = it->second.cert_record->Clone()->AsRecordVal();
+	return true;
+	}
+
+void file_analysis::X509::InsertCache(X509Val* cert_val, RecordVal* cert_record)
+	{
+	auto res = cert_cache.emplace(cert_data, CachedCert{cert_val, 0, cert_cache_lru.end()});
+
+	if ( ! res.second )
+		return;
+
+	cert_val->Ref();
+	res.first->second.cert_record = cert_record->Clone()->AsRecordVal();
+	cert_cache_lru.push_front(&res.first->first);
+	res.first->second.lru_pos = cert_cache_lru.begin();
+
+	while ( cert_cache.size() > BifConst::X509::certificate_cache_size )
+		{
+		auto victim = cert_cache.find(*cert_cache_lru.back());
+		Unref(victim->second.cert_val);
+		Unref(victim->second.cert_record);
+		cert_cache_lru.pop_back();
+		cert_cache.erase(victim);
+		++cert_cache_stats.evictions;
+		}
+	}
+
+bool file_analysis::X509::SkipCache() const
+	{
+	// Scripts may assign a new set, so only the ID is kept around.
+	static ::ID* uncached_files = lookup_ID("X509::uncached_files", GLOBAL_MODULE_NAME);
+
+	if ( ! uncached_files || ! uncached_files->ID_Val() )
+		return false;
+
+	TableVal* skip = uncached_files->ID_Val()->AsTableVal();
+
+	// Opting out is rare, so avoid building the lookup key normally.
+	if ( skip->Size() == 0 )
+		return false;
+
+	StringVal* id = new StringVal(GetFile()->GetID());
+	bool rval = skip->Lookup(id, false);
+	Unref(id);
+	return rval;
+	}
+
+file_analysis::X509::CacheStats file_analysis::X509::GetCacheStats()
+	{
+	CacheStats rval = cert_cache_stats;
+	rval.entries = cert_cache.size();
+	return rval;
+	}
+
+void file_analysis::X509::ClearCache()
+	{
+	for ( auto& entry : cert_cache )
+		{
+		Unref(entry.second.cert_val);
+		Unref(entry.second.cert_record);
+		}
+
+	cert_cache.clear();
+	cert_cache_lru.clear();
+	}
+
 RecordVal* file_analysis::X509::ParseCertificate(X509Val* cert_val, File* f)
 	{
 	::X509* ssl_cert = cert_val->GetCertificate();
@@ -89,10 +89,49 @@ public:
 	static file_analysis::Analyzer* Instantiate(RecordVal* args, File* file)
 		{ return new X509(args, file); }
 
+	/**
+	 * Counters of the cache of parsed certificates, see
+	 * :zeek:see:`X509::certificate_cache_size`.
+	 */
+	struct CacheStats {
+		uint64_t hits;
+		uint64_t misses;
+		uint64_t evictions;
+		uint64_t entries;
+	};
+
+	/**
+	 * @return the current counters of the certificate cache.
+	 */
+	static CacheStats GetCacheStats();
+
+	/**
+	 * Removes all certificates from the cache.
+	 */
+	static void ClearCache();
+
 protected:
 	X509(RecordVal* args, File* file);
 
 private:
+	/**
+	 * Looks up the certificate in the cache.
+	 * @return true if it was found, in which case \a cert_val and
+	 *         \a cert_record are set to new references.
+	 */
+	bool LookupCache(X509Val** cert_val, RecordVal** cert_record);
+
+	/**
+	 * Adds a freshly parsed certificate to the cache, evicting the least
+	 * recently used ones if the cache is full.
+	 */
+	void InsertCache(X509Val* cert_val, RecordVal* cert_record);
+
+	/**
+	 * @return true if scripts opted out of the cache for this file.
+	 */
+	bool SkipCache() const;
+
 	void ParseBasicConstraints(X509_EXTENSION* ex);
 	void ParseSAN(X509_EXTENSION* ex);
 	void ParseExtensionsSpecific(X509_EXTENSION* ex, bool, ASN1_OBJECT*, const char*) override;
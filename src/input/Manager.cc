@@ -1,6 +1,7 @@
 // See the file "COPYING" in the main distribution directory for copyright.
 
 #include <algorithm>
+#include <unordered_map>
 
 #include "Manager.h"
 #include "ReaderFrontend.h"
@@ -110,6 +111,12 @@ public:
 	PDict<InputHash>* currDict;
 	PDict<InputHash>* lastDict;
 
+	// If the reader diffs the entries, the table's current entries
+	// keyed by their serialized index values. currDict and
+	// lastDict remain unused then.
+	bool diff_in_reader;
+	std::unordered_map<std::string, InputHash*> diff_entries;
+
 	Func* pred;
 
 	EventHandlerPtr event;
@@ -141,7 +148,7 @@ public:
 Manager::TableStream::TableStream()
 	: Manager::Stream::Stream(TABLE_STREAM),
 	  num_idx_fields(), num_val_fields(), want_record(), tab(), rtype(),
-	  itype(), currDict(), lastDict(), pred(), event()
+	  itype(), currDict(), lastDict(), diff_in_reader(), pred(), event()
 	{
 	}
 
@@ -179,6 +186,9 @@ Manager::TableStream::~TableStream()
 		lastDict->Clear();;
 		delete lastDict;
 		}
+
+	for ( const auto& e : diff_entries )
+		delete e.second;
 	}
 
 Manager::AnalysisStream::AnalysisStream()
@@ -223,7 +233,7 @@ ReaderBackend* Manager::CreateBackend(ReaderFrontend* frontend, EnumVal* tag)
 	}
 
 // Create a new input reader object to be used at whomevers leisure later on.
-bool Manager::CreateStream(Stream* info, RecordVal* description)
+bool Manager::CreateStream(Stream* info, RecordVal* description, int diff_index_fields)
 	{
 	RecordType* rtype = description->Type()->AsRecordType();
 	if ( ! ( same_type(rtype, BifType::Record::Input::TableDescription, 0)
@@ -282,6 +292,10 @@ bool Manager::CreateStream(Stream* info, RecordVal* description)
 
 	Unref(mode);
 
+	// Streaming readers don't resend their data, so there's nothing to diff.
+	if ( rinfo.mode != MODE_STREAM )
+		rinfo.diff_index_fields = diff_index_fields;
+
 	Val* config = description->Lookup("config", true);
 	info->config = config->AsTableVal(); // ref'd by LookupWithDefault
 
@@ -683,9 +697,13 @@ bool Manager::CreateTableStream(RecordVal* fval)
 		return false;
 		}
 
+	Val* diff_val = fval->Lookup("diff_in_reader", true);
+	bool diff_in_reader = diff_val->AsBool();
+	Unref(diff_val);
+
 	TableStream* stream = new TableStream();
 		{
-		bool res = CreateStream(stream, fval);
+		bool res = CreateStream(stream, fval, diff_in_reader ? idxfields : 0);
 		if ( ! res )
 			{
 			delete stream;
@@ -710,6 +728,7 @@ bool Manager::CreateTableStream(RecordVal* fval)
 	stream->lastDict = new PDict<InputHash>;
 	stream->lastDict->SetDeleteFunc(input_hash_delete_func);
 	stream->want_record = ( want_record->InternalInt() == 1 );
+	stream->diff_in_reader = ( stream->reader->Info().diff_index_fields > 0 );
 
 	Unref(want_record); // ref'd by lookupwithdefault
 	Unref(pred);
@@ -1126,52 +1145,79 @@ int Manager::SendEntryTable(Stream* i, const Value* const *vals)
 	assert(i->stream_type == TABLE_STREAM);
 	TableStream* stream = (TableStream*) i;
 
-	HashKey* idxhash = HashValues(stream->num_idx_fields, vals);
+	HashKey* idxhash = 0;
+	std::string idxdata;
+	hash_t valhash = 0;
+	InputHash *h = 0;
 
-	if ( idxhash == 0 )
+	if ( stream->diff_in_reader )
 		{
-		Warning(i, "Could not hash line. Ignoring");
-		return stream->num_val_fields + stream->num_idx_fields;
-		}
+		// The reader has already filtered out the unchanged entries,
+		// so anything we know about has been updated.
+		idxdata = ReaderBackend::Serialize(stream->num_idx_fields, vals);
+		auto e = stream->diff_entries.find(idxdata);
 
-	hash_t valhash = 0;
-	if ( stream->num_val_fields > 0 )
-		{
-		HashKey* valhashkey = HashValues(stream->num_val_fields, vals+stream->num_idx_fields);
-		if ( valhashkey == 0 )
+		if ( e != stream->diff_entries.end() )
 			{
-			// empty line. index, but no values.
-			// hence we also have no hash value...
-			}
-		else
-			{
-			valhash = valhashkey->Hash();
-			delete(valhashkey);
+			// For sets, this is an entry whose removal the
+			// predicate refused earlier; it's still in place.
+			if ( stream->num_val_fields == 0 )
+				return stream->num_val_fields + stream->num_idx_fields;
+
+			h = e->second;
+			stream->diff_entries.erase(e);
+			updated = true;
 			}
 		}
 
-	InputHash *h = stream->lastDict->Lookup(idxhash);
-	if ( h != 0 )
+	else
 		{
-		// seen before
-		if ( stream->num_val_fields == 0 || h->valhash == valhash )
+		idxhash = HashValues(stream->num_idx_fields, vals);
+
+		if ( idxhash == 0 )
 			{
-			// ok, exact duplicate, move entry to new dicrionary and do nothing else.
-			stream->lastDict->Remove(idxhash);
-			stream->currDict->Insert(idxhash, h);
-			delete idxhash;
+			Warning(i, "Could not hash line. Ignoring");
 			return stream->num_val_fields + stream->num_idx_fields;
 			}
 
-		else
+		if ( stream->num_val_fields > 0 )
 			{
-			assert( stream->num_val_fields > 0 );
-			// entry was updated in some way
-			stream->lastDict->Remove(idxhash);
-			// keep h for predicates
-			updated = true;
+			HashKey* valhashkey = HashValues(stream->num_val_fields, vals+stream->num_idx_fields);
+			if ( valhashkey == 0 )
+				{
+				// empty line. index, but no values.
+				// hence we also have no hash value...
+				}
+			else
+				{
+				valhash = valhashkey->Hash();
+				delete(valhashkey);
+				}
 			}
 
+		h = stream->lastDict->Lookup(idxhash);
+		if ( h != 0 )
+			{
+			// seen before
+			if ( stream->num_val_fields == 0 || h->valhash == valhash )
+				{
+				// ok, exact duplicate, move entry to new dicrionary and do nothing else.
+				stream->lastDict->Remove(idxhash);
+				stream->currDict->Insert(idxhash, h);
+				delete idxhash;
+				return stream->num_val_fields + stream->num_idx_fields;
+				}
+
+			else
+				{
+				assert( stream->num_val_fields > 0 );
+				// entry was updated in some way
+				stream->lastDict->Remove(idxhash);
+				// keep h for predicates
+				updated = true;
+				}
+
+			}
 		}
 
 	Val* valval;
@@ -1229,7 +1275,11 @@ int Manager::SendEntryTable(Stream* i, const Value* const *vals)
 				else
 					{
 					// keep old one
-					stream->currDict->Insert(idxhash, h);
+					if ( stream->diff_in_reader )
+						stream->diff_entries[idxdata] = h;
+					else
+						stream->currDict->Insert(idxhash, h);
+
 					delete idxhash;
 					return stream->num_val_fields + stream->num_idx_fields;
 					}
@@ -1289,7 +1339,11 @@ int Manager::SendEntryTable(Stream* i, const Value* const *vals)
 	if ( predidx != 0 )
 		Unref(predidx);
 
-	stream->currDict->Insert(idxhash, ih);
+	if ( stream->diff_in_reader )
+		stream->diff_entries[std::move(idxdata)] = ih;
+	else
+		stream->currDict->Insert(idxhash, ih);
+
 	delete idxhash;
 
 	if ( stream->event )
@@ -1327,7 +1381,7 @@ int Manager::SendEntryTable(Stream* i, const Value* const *vals)
 	return stream->num_val_fields + stream->num_idx_fields;
 	}
 
-void Manager::EndCurrentSend(ReaderFrontend* reader)
+void Manager::EndCurrentSend(ReaderFrontend* reader, const std::vector<std::string>* removed)
 	{
 	Stream *i = FindStream(reader);
 
@@ -1355,6 +1409,32 @@ void Manager::EndCurrentSend(ReaderFrontend* reader)
 	assert(i->stream_type == TABLE_STREAM);
 	TableStream* stream = (TableStream*) i;
 
+	if ( stream->diff_in_reader )
+		{
+		// The reader tells us which entries are gone.
+		if ( removed )
+			{
+			for ( const auto& idx : *removed )
+				{
+				auto e = stream->diff_entries.find(idx);
+
+				// We may never have added it, e.g. if the
+				// predicate refused it.
+				if ( e == stream->diff_entries.end() )
+					continue;
+
+				if ( RemoveTableEntry(stream, e->second->idxkey) )
+					{
+					delete e->second;
+					stream->diff_entries.erase(e);
+					}
+				}
+			}
+
+		SendEndOfData(i);
+		return;
+		}
+
 	// lastdict contains all deleted entries and should be empty apart from that
 	IterCookie *c = stream->lastDict->InitForIteration();
 	stream->lastDict->MakeRobustCookie(c);
@@ -1363,61 +1443,15 @@ void Manager::EndCurrentSend(ReaderFrontend* reader)
 
 	while ( ( ih = stream->lastDict->NextEntry(lastDictIdxKey, c) ) )
 		{
-		ListVal * idx = 0;
-		Val *val = 0;
-
-		Val* predidx = 0;
-		EnumVal* ev = 0;
-		int startpos = 0;
-
-		if ( stream->pred || stream->event )
-			{
-			idx = stream->tab->RecoverIndex(ih->idxkey);
-			assert(idx != 0);
-			val = stream->tab->Lookup(idx);
-			assert(val != 0);
-			predidx = ListValToRecordVal(idx, stream->itype, &startpos);
-			Unref(idx);
-			ev = BifType::Enum::Input::Event->GetVal(BifEnum::Input::EVENT_REMOVED);
-			}
-
-		if ( stream->pred )
+		if ( ! RemoveTableEntry(stream, ih->idxkey) )
 			{
-			// ask predicate, if we want to expire this element...
-
-			Ref(ev);
-			Ref(predidx);
-			Ref(val);
-
-			bool result = CallPred(stream->pred, 3, ev, predidx, val);
-
-			if ( result == false )
-				{
-				// Keep it. Hence - we quit and simply go to the next entry of lastDict
-				// ah well - and we have to add the entry to currDict...
-				Unref(predidx);
-				Unref(ev);
-				stream->currDict->Insert(lastDictIdxKey, stream->lastDict->RemoveEntry(lastDictIdxKey));
-				delete lastDictIdxKey;
-				continue;
-				}
-			}
-
-		if ( stream->event )
-			{
-			Ref(predidx);
-			Ref(val);
-			Ref(ev);
-			SendEvent(stream->event, 4, stream->description->Ref(), ev, predidx, val);
+			// Keep it. Hence - we quit and simply go to the next entry of lastDict
+			// ah well - and we have to add the entry to currDict...
+			stream->currDict->Insert(lastDictIdxKey, stream->lastDict->RemoveEntry(lastDictIdxKey));
+			delete lastDictIdxKey;
+			continue;
 			}
 
-		if ( predidx )  // if we have a stream or an event...
-			Unref(predidx);
-
-		if ( ev )
-			Unref(ev);
-
-		Unref(stream->tab->Delete(ih->idxkey));
 		stream->lastDict->Remove(lastDictIdxKey); // delete in next line
 		delete lastDictIdxKey;
 		delete(ih);
@@ -1438,6 +1472,63 @@ void Manager::EndCurrentSend(ReaderFrontend* reader)
 	SendEndOfData(i);
 	}
 
+bool Manager::RemoveTableEntry(Stream* i, const HashKey* idxkey)
+	{
+	assert(i->stream_type == TABLE_STREAM);
+	TableStream* stream = (TableStream*) i;
+
+	Val *val = 0;
+	Val* predidx = 0;
+	EnumVal* ev = 0;
+	int startpos = 0;
+
+	if ( stream->pred || stream->event )
+		{
+		ListVal* idx = stream->tab->RecoverIndex(idxkey);
+		assert(idx != 0);
+		val = stream->tab->Lookup(idx);
+		assert(val != 0);
+		predidx = ListValToRecordVal(idx, stream->itype, &startpos);
+		Unref(idx);
+		ev = BifType::Enum::Input::Event->GetVal(BifEnum::Input::EVENT_REMOVED);
+		}
+
+	if ( stream->pred )
+		{
+		// ask predicate, if we want to expire this element...
+
+		Ref(ev);
+		Ref(predidx);
+		Ref(val);
+
+		bool result = CallPred(stream->pred, 3, ev, predidx, val);
+
+		if ( result == false )
+			{
+			Unref(predidx);
+			Unref(ev);
+			return false;
+			}
+		}
+
+	if ( stream->event )
+		{
+		Ref(predidx);
+		Ref(val);
+		Ref(ev);
+		SendEvent(stream->event, 4, stream->description->Ref(), ev, predidx, val);
+		}
+
+	if ( predidx )  // if we have a stream or an event...
+		Unref(predidx);
+
+	if ( ev )
+		Unref(ev);
+
+	Unref(stream->tab->Delete(idxkey));
+	return true;
+	}
+
 void Manager::SendEndOfData(ReaderFrontend* reader)
 	{
 	Stream *i = FindStream(reader);
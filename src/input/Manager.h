@@ -11,6 +11,7 @@
 #include "Component.h"
 
 #include <map>
+#include <vector>
 
 namespace input {
 
@@ -137,8 +138,10 @@ protected:
 	// For readers to write to input stream in indirect mode (manager is
 	// monitoring new/deleted values) Functions take ownership of
 	// threading::Value fields.
+	// If the reader diffs the entries itself, it passes the serialized
+	// index values of the removed entries to EndCurrentSend().
 	void SendEntry(ReaderFrontend* reader, threading::Value* *vals);
-	void EndCurrentSend(ReaderFrontend* reader);
+	void EndCurrentSend(ReaderFrontend* reader, const std::vector<std::string>* removed = 0);
 
 	// Allows readers to directly send Bro events. The num_vals and vals
 	// must be the same the named event expects. Takes ownership of
@@ -184,7 +187,7 @@ private:
 	// protected definitions are wrappers around this function.
 	bool RemoveStream(Stream* i);
 
-	bool CreateStream(Stream*, RecordVal* description);
+	bool CreateStream(Stream*, RecordVal* description, int diff_index_fields = 0);
 
 	// Check if the types of the error_ev event are correct. If table is
 	// true, check for tablestream type, otherwhise check for eventstream
@@ -194,6 +197,11 @@ private:
 	// SendEntry implementation for Table stream.
 	int SendEntryTable(Stream* i, const threading::Value* const *vals);
 
+	// Removes an entry that has gone from the input source from a Table
+	// stream's table, unless the predicate vetoes it. Returns false if
+	// the entry was kept.
+	bool RemoveTableEntry(Stream* i, const HashKey* idxkey);
+
 	// Put implementation for Table stream.
 	int PutTable(Stream* i, const threading::Value* const *vals);
 
@@ -116,16 +116,22 @@ private:
 
 class EndCurrentSendMessage : public threading::OutputMessage<ReaderFrontend> {
 public:
-	EndCurrentSendMessage(ReaderFrontend* reader)
-		: threading::OutputMessage<ReaderFrontend>("EndCurrentSend", reader) {}
+	EndCurrentSendMessage(ReaderFrontend* reader, std::vector<std::string>* removed = 0)
+		: threading::OutputMessage<ReaderFrontend>("EndCurrentSend", reader),
+		removed(removed) {}
+
+	virtual ~EndCurrentSendMessage()	{ delete removed; }
 
 	virtual bool Process()
 		{
-		input_mgr->EndCurrentSend(Object());
+		input_mgr->EndCurrentSend(Object(), removed);
 		return true;
 		}
 
 private:
+	// Serialized index values of the entries gone since the last read, if
+	// the reader does the diffing.
+	std::vector<std::string>* removed;
 };
 
 class EndOfDataMessage : public threading::OutputMessage<ReaderFrontend> {
@@ -236,7 +242,23 @@ void ReaderBackend::SendEvent(const char* name, const int num_vals, Value* *vals
 
 void ReaderBackend::EndCurrentSend()
 	{
-	SendOut(new EndCurrentSendMessage(frontend));
+	if ( ! info->diff_index_fields )
+		{
+		SendOut(new EndCurrentSendMessage(frontend));
+		return;
+		}
+
+	// Whatever we haven't seen again during this read is gone.
+	std::vector<std::string>* removed = new std::vector<std::string>;
+	removed->reserve(last_entries.size());
+
+	for ( const auto& e : last_entries )
+		removed->push_back(e.first);
+
+	last_entries.clear();
+	last_entries.swap(curr_entries);
+
+	SendOut(new EndCurrentSendMessage(frontend, removed));
 	}
 
 void ReaderBackend::EndOfData()
@@ -244,11 +266,137 @@ void ReaderBackend::EndOfData()
 	SendOut(new EndOfDataMessage(frontend));
 	}
 
+static void append_value(std::string* buf, const Value* val);
+
 void ReaderBackend::SendEntry(Value* *vals)
 	{
+	int idx_fields = info->diff_index_fields;
+
+	if ( idx_fields )
+		{
+		std::string idx = Serialize(idx_fields, vals);
+		hash_t val = Fingerprint(num_fields - idx_fields, vals + idx_fields);
+
+		auto last = last_entries.find(idx);
+		bool unchanged = (last != last_entries.end() && last->second == val);
+
+		if ( last != last_entries.end() )
+			last_entries.erase(last);
+
+		curr_entries[std::move(idx)] = val;
+
+		if ( unchanged )
+			{
+			for ( unsigned int i = 0; i < num_fields; ++i )
+				delete vals[i];
+
+			delete [] vals;
+			return;
+			}
+		}
+
 	SendOut(new SendEntryMessage(frontend, vals));
 	}
 
+static void append_value(std::string* buf, const Value* val)
+	{
+	// Tag each value with its type and presence, so that neither
+	// missing fields nor container boundaries can cause ambiguities.
+	buf->push_back(char(val->type));
+	buf->push_back(char(val->present));
+
+	if ( ! val->present )
+		return;
+
+	switch ( val->type ) {
+	case TYPE_BOOL:
+	case TYPE_INT:
+		buf->append((const char*) &val->val.int_val, sizeof(val->val.int_val));
+		break;
+
+	case TYPE_COUNT:
+	case TYPE_COUNTER:
+		buf->append((const char*) &val->val.uint_val, sizeof(val->val.uint_val));
+		break;
+
+	case TYPE_PORT:
+		buf->append((const char*) &val->val.port_val.port, sizeof(val->val.port_val.port));
+		buf->append((const char*) &val->val.port_val.proto, sizeof(val->val.port_val.proto));
+		break;
+
+	case TYPE_DOUBLE:
+	case TYPE_TIME:
+	case TYPE_INTERVAL:
+		buf->append((const char*) &val->val.double_val, sizeof(val->val.double_val));
+		break;
+
+	case TYPE_STRING:
+	case TYPE_ENUM:
+		buf->append((const char*) &val->val.string_val.length, sizeof(val->val.string_val.length));
+		buf->append(val->val.string_val.data, val->val.string_val.length);
+		break;
+
+	case TYPE_ADDR:
+		if ( val->val.addr_val.family == IPv4 )
+			buf->append((const char*) &val->val.addr_val.in.in4, sizeof(val->val.addr_val.in.in4));
+		else
+			buf->append((const char*) &val->val.addr_val.in.in6, sizeof(val->val.addr_val.in.in6));
+		break;
+
+	case TYPE_SUBNET:
+		if ( val->val.subnet_val.prefix.family == IPv4 )
+			buf->append((const char*) &val->val.subnet_val.prefix.in.in4, sizeof(val->val.subnet_val.prefix.in.in4));
+		else
+			buf->append((const char*) &val->val.subnet_val.prefix.in.in6, sizeof(val->val.subnet_val.prefix.in.in6));
+
+		buf->push_back(char(val->val.subnet_val.length));
+		break;
+
+	case TYPE_PATTERN:
+		buf->append(val->val.pattern_text_val, strlen(val->val.pattern_text_val) + 1);
+		break;
+
+	case TYPE_TABLE:
+		buf->append((const char*) &val->val.set_val.size, sizeof(val->val.set_val.size));
+
+		for ( int i = 0; i < val->val.set_val.size; ++i )
+			append_value(buf, val->val.set_val.vals[i]);
+		break;
+
+	case TYPE_VECTOR:
+		buf->append((const char*) &val->val.vector_val.size, sizeof(val->val.vector_val.size));
+
+		for ( int i = 0; i < val->val.vector_val.size; ++i )
+			append_value(buf, val->val.vector_val.vals[i]);
+		break;
+
+	default:
+		// Other types carry no content the readers could fill in.
+		break;
+	}
+	}
+
+std::string ReaderBackend::Serialize(int num_vals, const Value* const* vals)
+	{
+	std::string buf;
+
+	for ( int i = 0; i < num_vals; ++i )
+		append_value(&buf, vals[i]);
+
+	return buf;
+	}
+
+hash_t ReaderBackend::Fingerprint(int num_vals, const Value* const* vals)
+	{
+	static thread_local std::string buf;
+	buf.clear();
+
+	for ( int i = 0; i < num_vals; ++i )
+		append_value(&buf, vals[i]);
+
+	return HashKey::HashBytes(buf.data(), buf.size());
+	}
+
 bool ReaderBackend::Init(const int arg_num_fields,
 		         const threading::Field* const* arg_fields)
 	{
@@ -304,7 +452,16 @@ bool ReaderBackend::Update()
 
 	bool success = DoUpdate();
 	if ( ! success )
+		{
+		// The read got cut short before EndCurrentSend(). The entries
+		// sent so far are known to the manager now, so the next read
+		// must diff against them as well as the ones not seen yet.
+		for ( auto& e : curr_entries )
+			last_entries[e.first] = e.second;
+
+		curr_entries.clear();
 		DisableFrontend();
+		}
 
 	return ! disabled; // always return failure if we have been disabled in the meantime
 	}
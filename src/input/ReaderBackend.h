@@ -2,7 +2,12 @@
 
 #pragma once
 
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "BroString.h"
+#include "Hash.h"
 
 #include "threading/SerialTypes.h"
 #include "threading/MsgThread.h"
@@ -102,11 +107,21 @@ public:
 		 */
 		ReaderMode mode;
 
+		/**
+		 * If non-zero, the backend compares the entries passed to
+		 * SendEntry() with those of the previous read and forwards
+		 * only the ones that were added or changed, keyed by their
+		 * first diff_index_fields values. Set for table streams with
+		 * \c diff_in_reader enabled.
+		 */
+		int diff_index_fields;
+
 		ReaderInfo()
 			{
 			source = 0;
 			name = 0;
 			mode = MODE_NONE;
+			diff_index_fields = 0;
 			}
 
 		ReaderInfo(const ReaderInfo& other)
@@ -114,6 +129,7 @@ public:
 			source = other.source ? copy_string(other.source) : 0;
 			name = other.name ? copy_string(other.name) : 0;
 			mode = other.mode;
+			diff_index_fields = other.diff_index_fields;
 
 			for ( config_map::const_iterator i = other.config.begin(); i != other.config.end(); i++ )
 				config.insert(std::make_pair(copy_string(i->first), copy_string(i->second)));
@@ -184,6 +200,29 @@ public:
 	 */
 	int NumFields() const	{ return num_fields; }
 
+	/**
+	 * Computes a fingerprint over the contents of a list of values.
+	 * Lists with equal contents yield equal fingerprints. Used to diff
+	 * table stream entries between reads; safe to call from any thread.
+	 *
+	 * @param num_vals The number of entries in \a vals.
+	 *
+	 * @param vals The values to fingerprint.
+	 */
+	static hash_t Fingerprint(int num_vals, const threading::Value* const* vals);
+
+	/**
+	 * Serializes the contents of a list of values into a string. Lists
+	 * yield equal strings exactly if their contents are equal, so the
+	 * result can key table stream entries by their full index values.
+	 * Safe to call from any thread.
+	 *
+	 * @param num_vals The number of entries in \a vals.
+	 *
+	 * @param vals The values to serialize.
+	 */
+	static std::string Serialize(int num_vals, const threading::Value* const* vals);
+
 	// Overridden from MsgThread.
 	bool OnHeartbeat(double network_time, double current_time) override;
 	bool OnFinish(double network_time) override;
@@ -323,6 +362,10 @@ protected:
 	 * If the stream is a table stream, the values are inserted into the
 	 * table; if it is an event stream, the event is raised.
 	 *
+	 * If the stream diffs entries in the reader (see
+	 * ReaderInfo::diff_index_fields), entries that did not change since
+	 * the previous read are dropped here already.
+	 *
 	 * @param val Array of threading::Values expected by the stream. The
 	 * array must have exactly NumEntries() elements.
 	 */
@@ -339,6 +382,10 @@ protected:
 	void EndCurrentSend();
 
 private:
+	// Maps the serialized index values of an entry seen by the diffing
+	// to the fingerprint of its other values.
+	typedef std::unordered_map<std::string, hash_t> fingerprint_map;
+
 	// Frontend that instantiated us. This object must not be accessed
 	// from this class, it's running in a different thread!
 	ReaderFrontend* frontend;
@@ -348,6 +395,12 @@ private:
 	const threading::Field* const * fields; // raw mapping
 
 	bool disabled;
+
+	// With diffing enabled, the entries sent during the previous and
+	// the current read, keyed by their index values. Entries seen again
+	// are moved from the former into the latter.
+	fingerprint_map last_entries;
+	fingerprint_map curr_entries;
 };
 
 }
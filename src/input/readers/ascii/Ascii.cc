@@ -4,6 +4,7 @@
 
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
 #include <errno.h>
 
@@ -53,6 +54,7 @@ Ascii::Ascii(ReaderFrontend *frontend) : ReaderBackend(frontend)
 	suppress_warnings = false;
 	fail_on_file_problem = false;
 	fail_on_invalid_lines = false;
+	fast_mode = false;
 	}
 
 Ascii::~Ascii()
@@ -85,6 +87,8 @@ bool Ascii::DoInit(const ReaderInfo& info, int num_fields, const Field* const* f
 	path_prefix.assign((const char*) BifConst::InputAscii::path_prefix->Bytes(),
 	                   BifConst::InputAscii::path_prefix->Len());
 
+	fast_mode = BifConst::InputAscii::fast_mode;
+
 	// Set per-filter configuration options.
 	for ( ReaderInfo::config_map::const_iterator i = info.config.begin(); i != info.config.end(); i++ )
 		{
@@ -105,8 +109,16 @@ bool Ascii::DoInit(const ReaderInfo& info, int num_fields, const Field* const* f
 
 		else if ( strcmp(i->first, "fail_on_file_problem") == 0 )
 			fail_on_file_problem = (strncmp(i->second, "T", 1) == 0);
+
+		else if ( strcmp(i->first, "fast_mode") == 0 )
+			fast_mode = (strncmp(i->second, "T", 1) == 0);
 		}
 
+	// Fast mode reads the whole file at once, which doesn't suit a
+	// growing file.
+	if ( info.mode == MODE_STREAM )
+		fast_mode = false;
+
 	if ( separator.size() != 1 )
 		Error("separator length has to be 1. Separator will be truncated.");
 
@@ -135,11 +147,8 @@ void Ascii::FailWarn(bool is_error, const char *msg, bool suppress_future)
 		}
 	}
 
-bool Ascii::OpenFile()
+void Ascii::SetFileName()
 	{
-	if ( file.is_open() )
-		return true;
-
 	// Handle path-prefixing. See similar logic in Binary::DoInit().
 	fname = Info().source;
 
@@ -155,7 +164,14 @@ bool Ascii::OpenFile()
 
 		fname = path + "/" + fname;
 		}
+	}
 
+bool Ascii::OpenFile()
+	{
+	if ( file.is_open() )
+		return true;
+
+	SetFileName();
 	file.open(fname);
 
 	if ( ! file.is_open() )
@@ -285,6 +301,9 @@ bool Ascii::GetLine(string& str)
 // read the entire file and send appropriate thingies back to InputMgr
 bool Ascii::DoUpdate()
 	{
+	if ( fast_mode )
+		return DoUpdateFast();
+
 	if ( ! OpenFile() )
 		return ! fail_on_file_problem;
 
@@ -461,9 +480,358 @@ bool Ascii::DoUpdate()
 	return true;
 	}
 
+bool Ascii::DoUpdateFast()
+	{
+	SetFileName();
+
+	int fd = open(fname.c_str(), O_RDONLY);
+
+	if ( fd < 0 )
+		{
+		FailWarn(fail_on_file_problem, Fmt("Init: cannot open %s", fname.c_str()), true);
+		return ! fail_on_file_problem;
+		}
+
+	struct stat sb;
+	if ( fstat(fd, &sb) == -1 )
+		{
+		FailWarn(fail_on_file_problem, Fmt("Could not get stat for %s", fname.c_str()), true);
+		close(fd);
+		return ! fail_on_file_problem;
+		}
+
+	if ( Info().mode == MODE_REREAD )
+		{
+		if ( sb.st_ino == ino && sb.st_mtime == mtime )
+			{
+			// no change
+			close(fd);
+			return true;
+			}
+
+		if ( ino != 0 )
+			suppress_warnings = false;
+
+		mtime = sb.st_mtime;
+		ino = sb.st_ino;
+		}
+
+	// Read the file into memory rather than mapping it.  If the file gets
+	// truncated while being read, accessing a mapping beyond its new end
+	// would raise SIGBUS; read() just returns less.
+	size_t size = sb.st_size;
+	std::unique_ptr<char[]> data(new char[size > 0 ? size : 1]);
+	size_t have = 0;
+
+	while ( have < size )
+		{
+		ssize_t n = read(fd, data.get() + have, size - have);
+
+		if ( n < 0 )
+			{
+			if ( errno == EINTR )
+				continue;
+
+			FailWarn(fail_on_file_problem, Fmt("Could not read %s: %s", fname.c_str(), strerror(errno)), true);
+			close(fd);
+			return ! fail_on_file_problem;
+			}
+
+		if ( n == 0 )
+			break;
+
+		have += n;
+		}
+
+	close(fd);
+
+	return ReadBuffer(data.get(), have);
+	}
+
+bool Ascii::NextBufferLine(const char** pos, const char* end, const char** line, size_t* len)
+	{
+	while ( *pos < end )
+		{
+		const char* start = *pos;
+		const char* nl = (const char*) memchr(start, '\n', end - start);
+		size_t n = (nl ? nl : end) - start;
+		*pos = nl ? nl + 1 : end;
+
+		if ( n == 0 )
+			continue;
+
+		if ( start[n - 1] == '\r' ) // deal with \r\n by removing \r
+			--n;
+
+		if ( n == 0 || start[0] != '#' )
+			{
+			*line = start;
+			*len = n;
+			return true;
+			}
+
+		if ( n > 8 && memcmp(start, "#fields", 7) == 0 && start[7] == separator[0] )
+			{
+			*line = start + 8;
+			*len = n - 8;
+			return true;
+			}
+		}
+
+	return false;
+	}
+
+void Ascii::SplitBufferLine(const char* line, size_t len)
+	{
+	linefields.clear();
+
+	const char* end = line + len;
+	const char* p = line;
+
+	while ( p < end )
+		{
+		const char* sep = (const char*) memchr(p, separator[0], end - p);
+
+		if ( ! sep )
+			{
+			linefields.emplace_back(p, end - p);
+			return;
+			}
+
+		linefields.emplace_back(p, sep - p);
+		p = sep + 1;
+		}
+
+	// A trailing separator doesn't start another field, just like with
+	// getline().
+	}
+
+Value* Ascii::ParseBufferField(const char* s, size_t len, const FieldMapping& fm)
+	{
+	// The common cases are handled here directly. Anything else, or
+	// anything that the formatter would need to warn about, goes through
+	// the formatter for identical results.
+	if ( ! unset_field.empty() && len == unset_field.size() &&
+	     memcmp(s, unset_field.data(), len) == 0 )
+		return new Value(fm.type, false);
+
+	switch ( fm.type ) {
+	case TYPE_ENUM:
+	case TYPE_STRING:
+		{
+		if ( memchr(s, '\\', len) )
+			break;
+
+		Value* val = new Value(fm.type, fm.subtype, true);
+		char* data = new char[len + 1];
+		memcpy(data, s, len);
+		data[len] = '\0';
+		val->val.string_val.data = data;
+		val->val.string_val.length = len;
+		return val;
+		}
+
+	case TYPE_BOOL:
+		{
+		if ( len != 1 )
+			break;
+
+		if ( *s == 'T' || *s == '1' || *s == 'F' || *s == '0' )
+			{
+			Value* val = new Value(fm.type, fm.subtype, true);
+			val->val.int_val = ( *s == 'T' || *s == '1' );
+			return val;
+			}
+
+		break;
+		}
+
+	case TYPE_INT:
+	case TYPE_COUNT:
+	case TYPE_COUNTER:
+		{
+		bool negative = ( fm.type == TYPE_INT && len > 0 && *s == '-' );
+		size_t i = negative ? 1 : 0;
+
+		// Stay clear of overflows; longer numbers take the slow path.
+		if ( len == i || len - i > 18 )
+			break;
+
+		uint64_t n = 0;
+
+		for ( ; i < len; ++i )
+			{
+			if ( s[i] < '0' || s[i] > '9' )
+				break;
+
+			n = n * 10 + (s[i] - '0');
+			}
+
+		if ( i < len )
+			break;
+
+		Value* val = new Value(fm.type, fm.subtype, true);
+
+		if ( fm.type == TYPE_INT )
+			val->val.int_val = negative ? -bro_int_t(n) : bro_int_t(n);
+		else
+			val->val.uint_val = n;
+
+		return val;
+		}
+
+	case TYPE_DOUBLE:
+	case TYPE_TIME:
+	case TYPE_INTERVAL:
+		{
+		char buf[64];
+
+		if ( len == 0 || len >= sizeof(buf) )
+			break;
+
+		memcpy(buf, s, len);
+		buf[len] = '\0';
+
+		char* end;
+		errno = 0;
+		double d = strtod(buf, &end);
+
+		if ( end != buf + len || errno != 0 )
+			break;
+
+		Value* val = new Value(fm.type, fm.subtype, true);
+		val->val.double_val = d;
+		return val;
+		}
+
+	case TYPE_ADDR:
+		{
+		if ( len == 0 || memchr(s, '\\', len) ||
+		     isspace((unsigned char) s[0]) ||
+		     isspace((unsigned char) s[len - 1]) )
+			break;
+
+		Value* val = new Value(fm.type, fm.subtype, true);
+		val->val.addr_val = formatter->ParseAddr(string(s, len));
+		return val;
+		}
+
+	default:
+		break;
+	}
+
+	return formatter->ParseValue(string(s, len), fm.name, fm.type, fm.subtype);
+	}
+
+bool Ascii::ReadBuffer(const char* data, size_t size)
+	{
+	const char* next = data;
+	const char* end = data + size;
+	const char* line;
+	size_t len;
+
+	if ( ! NextBufferLine(&next, end, &line, &len) )
+		{
+		FailWarn(fail_on_file_problem, Fmt("Could not read input data file %s; first line could not be read",
+						   fname.c_str()), true);
+		FailWarn(fail_on_file_problem, Fmt("Init: cannot open %s; problem reading file header", fname.c_str()), true);
+		return ! fail_on_file_problem;
+		}
+
+	headerline.assign(line, len);
+
+	if ( ! ReadHeader(true) )
+		{
+		FailWarn(fail_on_file_problem, Fmt("Init: cannot open %s; problem reading file header", fname.c_str()), true);
+		return ! fail_on_file_problem;
+		}
+
+	suppress_warnings = false;
+
+	while ( NextBufferLine(&next, end, &line, &len) )
+		{
+		SplitBufferLine(line, len);
+
+		int pos = int(linefields.size()) - 1; // for easy comparisons of max element.
+		bool error = false;
+
+		Value** fields = new Value*[NumFields()];
+
+		int fpos = 0;
+		for ( const auto& fm : columnMap )
+			{
+			if ( ! fm.present )
+				{
+				// add non-present field
+				fields[fpos] = new Value(fm.type, false);
+				fpos++;
+				continue;
+				}
+
+			assert(fm.position >= 0 );
+
+			if ( fm.position > pos || fm.secondary_position > pos )
+				{
+				FailWarn(fail_on_invalid_lines, Fmt("Not enough fields in line '%s' of %s. Found %d fields, want positions %d and %d",
+				                                    string(line, len).c_str(), fname.c_str(), pos, fm.position, fm.secondary_position));
+
+				if ( fail_on_invalid_lines )
+					{
+					for ( int i = 0; i < fpos; i++ )
+						delete fields[i];
+
+					delete [] fields;
+
+					return false;
+					}
+
+				error = true;
+				break;
+				}
+
+			const auto& field = linefields[fm.position];
+			Value* val = ParseBufferField(field.first, field.second, fm);
+
+			if ( val == 0 )
+				{
+				Warning(Fmt("Could not convert line '%s' of %s to Val. Ignoring line.", string(line, len).c_str(), fname.c_str()));
+				error = true;
+				break;
+				}
+
+			if ( fm.secondary_position != -1 )
+				{
+				// we have a port definition :)
+				assert(val->type == TYPE_PORT );
+				const auto& proto = linefields[fm.secondary_position];
+				val->val.port_val.proto = formatter->ParseProto(string(proto.first, proto.second));
+				}
+
+			fields[fpos] = val;
+
+			fpos++;
+			}
+
+		if ( error )
+			{
+			for ( int i = 0; i < fpos; i++ )
+				delete fields[i];
+
+			delete [] fields;
+			continue;
+			}
+
+		assert ( fpos == NumFields() );
+		SendEntry(fields);
+		}
+
+	EndCurrentSend();
+	return true;
+	}
+
 bool Ascii::DoHeartbeat(double network_time, double current_time)
 	{
-	if ( ! OpenFile() )
+	if ( ! fast_mode && ! OpenFile() )
 		return ! fail_on_file_problem;
 
 	switch ( Info().mode )
@@ -6,6 +6,7 @@
 #include <vector>
 #include <fstream>
 #include <memory>
+#include <utility>
 #include <sys/types.h>
 
 #include "input/ReaderBackend.h"
@@ -56,6 +57,18 @@ private:
 	bool ReadHeader(bool useCached);
 	bool GetLine(string& str);
 	bool OpenFile();
+	void SetFileName();
+
+	// Fast mode: reads the whole file into memory at once and parses
+	// the fields in place.
+	bool DoUpdateFast();
+	bool ReadBuffer(const char* data, size_t size);
+	// Returns the next line of the buffer like GetLine() does, advancing
+	// *pos past it.
+	bool NextBufferLine(const char** pos, const char* end, const char** line, size_t* len);
+	// Splits a line on the separator into linefields, like getline() does.
+	void SplitBufferLine(const char* line, size_t len);
+	threading::Value* ParseBufferField(const char* s, size_t len, const FieldMapping& fm);
 	// Call Warning or Error, depending on the is_error boolean.
 	// In case of a warning, setting suppress_future to true will suppress all future warnings
 	// (by setting suppress_warnings to true, until suppress_warnings is set back to false)
@@ -84,6 +97,10 @@ private:
 	bool fail_on_invalid_lines;
 	bool fail_on_file_problem;
 	string path_prefix;
+	bool fast_mode;
+
+	// Start and length of each field of the current line in fast mode.
+	vector<std::pair<const char*, size_t>> linefields;
 
 	// this is an internal indicator in case the read is currently in a failed state
 	// it's used to suppress duplicate error messages.
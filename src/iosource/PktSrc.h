@@ -9,6 +9,8 @@
 #include "Dict.h"
 #include "Packet.h"
 
+class Connection;
+
 namespace iosource {
 
 /**
@@ -204,6 +206,22 @@ public:
 	 */
 	virtual void Statistics(Stats* stats) = 0;
 
+	/**
+	 * Signals that Zeek bypasses a connection from now on, i.e., that
+	 * it only counts the connection's further packets.  Sources that
+	 * support bypassing flows in hardware or in the kernel may stop
+	 * delivering the connection's packets altogether; those packets
+	 * then won't show up in the connection's bypass statistics.
+	 *
+	 * The default implementation does nothing.
+	 *
+	 * @param conn The connection being bypassed.
+	 *
+	 * @return True if the source will drop the connection's packets
+	 * itself, false if Zeek keeps receiving them.
+	 */
+	virtual bool BypassConnection(const Connection* conn)	{ return false; }
+
 protected:
 	friend class Manager;
 
@@ -1245,62 +1245,50 @@ WriterFrontend* Manager::CreateWriter(EnumVal* id, EnumVal* writer, WriterBacken
 
 void Manager::DeleteVals(int num_fields, threading::Value** vals)
 	{
-	// Note this code is duplicated in WriterBackend::DeleteVals().
-	for ( int i = 0; i < num_fields; i++ )
-		delete vals[i];
-
-	delete [] vals;
+	threading::Value::DeleteVals(num_fields, vals);
 	}
 
 bool Manager::WriteFromRemote(EnumVal* id, EnumVal* writer, string path, int num_fields,
 			      threading::Value** vals)
 	{
-	Stream* stream = FindStream(id);
+	WriterFrontend* w = FindRemoteWriter(id, writer, path);
 
-	if ( ! stream )
+	if ( ! w )
 		{
-		// Don't know this stream.
-#ifdef DEBUG
-		ODesc desc;
-		id->Describe(&desc);
-		DBG_LOG(DBG_LOGGING, "unknown stream %s in Manager::Write()",
-			desc.Description());
-#endif
 		DeleteVals(num_fields, vals);
-		return false;
-		}
 
-	if ( ! stream->enabled )
-		{
-		DeleteVals(num_fields, vals);
-		return true;
+		// Writes to disabled streams are dropped on purpose, while an
+		// unknown stream or writer is an error.
+		Stream* stream = FindStream(id);
+		return stream && ! stream->enabled;
 		}
 
-	Stream::WriterMap::iterator w =
-		stream->writers.find(Stream::WriterPathPair(writer->AsEnum(), path));
-
-	if ( w == stream->writers.end() )
-		{
-		// Don't know this writer.
-#ifdef DEBUG
-		ODesc desc;
-		id->Describe(&desc);
-		DBG_LOG(DBG_LOGGING, "unknown writer %s in Manager::Write()",
-			desc.Description());
-#endif
-		DeleteVals(num_fields, vals);
-		return false;
-		}
-
-	w->second->writer->Write(num_fields, vals);
+	w->Write(num_fields, vals);
 
 	DBG_LOG(DBG_LOGGING,
 		"Wrote pre-filtered record to path '%s' on stream '%s'",
-		path.c_str(), stream->name.c_str());
+		path.c_str(), FindStream(id)->name.c_str());
 
 	return true;
 	}
 
+WriterFrontend* Manager::FindRemoteWriter(EnumVal* id, EnumVal* writer,
+                                          const string& path)
+	{
+	Stream* stream = FindStream(id);
+
+	if ( ! (stream && stream->enabled) )
+		return 0;
+
+	Stream::WriterMap::iterator w =
+		stream->writers.find(Stream::WriterPathPair(writer->AsEnum(), path));
+
+	if ( w == stream->writers.end() )
+		return 0;
+
+	return w->second->writer;
+	}
+
 void Manager::SendAllWritersTo(const broker::endpoint_info& ei)
 	{
 	auto et = internal_type("Log::Writer")->AsEnumType();
@@ -169,6 +169,24 @@ public:
 	bool WriteFromRemote(EnumVal* stream, EnumVal* writer, string path,
 			     int num_fields, threading::Value** vals);
 
+	/**
+	 * Looks up the writer that WriteFromRemote() passes log writes for
+	 * the given stream, writer type and path to.  Callers writing many
+	 * records to the same target can use this to look it up only once.
+	 * The writer remains valid until scripts get to run again.
+	 *
+	 * @param stream The enum value corresponding to the log stream.
+	 *
+	 * @param writer The enum value corresponding to the desired log writer.
+	 *
+	 * @param path The path of the target log stream to write to.
+	 *
+	 * @return The writer, or null if writes to the target get dropped
+	 * because the stream is unknown or disabled or has no such writer.
+	 */
+	WriterFrontend* FindRemoteWriter(EnumVal* stream, EnumVal* writer,
+	                                 const string& path);
+
 	/**
 	 * Announces all instantiated writers to a given Broker peer.
 	 */
@@ -146,13 +146,7 @@ WriterBackend::~WriterBackend()
 void WriterBackend::DeleteVals(int num_writes, Value*** vals)
 	{
 	for ( int j = 0; j < num_writes; ++j )
-		{
-		// Note this code is duplicated in Manager::DeleteVals().
-		for ( int i = 0; i < num_fields; i++ )
-			delete vals[j][i];
-
-		delete [] vals[j];
-		}
+		Value::DeleteVals(num_fields, vals[j]);
 
 	delete [] vals;
 	}
@@ -279,9 +279,5 @@ void WriterFrontend::Rotate(const char* rotated_path, double open, double close,
 
 void WriterFrontend::DeleteVals(int num_fields, Value** vals)
 	{
-	// Note this code is duplicated in Manager::DeleteVals().
-	for ( int i = 0; i < num_fields; i++ )
-		delete vals[i];
-
-	delete [] vals;
+	Value::DeleteVals(num_fields, vals);
 	}
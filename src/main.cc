@@ -208,7 +208,9 @@ void usage(int code = 1)
 	fprintf(stderr, "    $ZEEK_LOG_SUFFIX               | ASCII log file extension (.%s)\n", logging::writer::Ascii::LogExt().c_str());
 	fprintf(stderr, "    $ZEEK_PROFILER_FILE            | Output file for script execution statistics (not set)\n");
 	fprintf(stderr, "    $ZEEK_DISABLE_ZEEKYGEN         | Disable Zeekygen documentation support (%s)\n", zeekenv("ZEEK_DISABLE_ZEEKYGEN") ? "set" : "not set");
+	fprintf(stderr, "    $ZEEK_HASH_TIER                | hash tier for fixed-size keys, \"fast\" or \"siphash\" (%s)\n", zeekenv("ZEEK_HASH_TIER") ? zeekenv("ZEEK_HASH_TIER") : "not set");
 	fprintf(stderr, "    $ZEEK_DNS_RESOLVER             | IPv4/IPv6 address of DNS resolver to use (%s)\n", zeekenv("ZEEK_DNS_RESOLVER") ? zeekenv("ZEEK_DNS_RESOLVER") : "not set, will use first IPv4 address from /etc/resolv.conf");
+	fprintf(stderr, "    $ZEEK_DNS_RESOLVER_PORT        | UDP port of the DNS resolver set by $ZEEK_DNS_RESOLVER (%s)\n", zeekenv("ZEEK_DNS_RESOLVER_PORT") ? zeekenv("ZEEK_DNS_RESOLVER_PORT") : "53");
 
 	fprintf(stderr, "\n");
 
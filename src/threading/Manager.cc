@@ -11,6 +11,7 @@ Manager::Manager()
 	did_process = true;
 	next_beat = 0;
 	terminating = false;
+	memset(&process_stats, 0, sizeof(process_stats));
 	SetIdle(true);
 	}
 
@@ -119,6 +120,16 @@ void Manager::Process()
 
 	did_process = false;
 
+	// While terminating, everything needs to be flushed out in one go.
+	double budget = terminating ? 0 : BifConst::Threading::max_process_time;
+	double start = current_time(true);
+	double now = start;
+	bool processed = false;
+
+	// The thread whose output we stopped processing at when running out
+	// of time, if any.
+	msg_thread_list::iterator deferred = msg_threads.end();
+
 	for ( msg_thread_list::iterator i = msg_threads.begin(); i != msg_threads.end(); i++ )
 		{
 		MsgThread* t = *i;
@@ -126,7 +137,7 @@ void Manager::Process()
 		if ( do_beat )
 			t->Heartbeat();
 
-		while ( t->HasOut() )
+		while ( deferred == msg_threads.end() && t->HasOut() )
 			{
 			Message* msg = t->RetrieveOut();
 			assert(msg);
@@ -144,6 +155,54 @@ void Manager::Process()
 				}
 
 			delete msg;
+			processed = true;
+
+			if ( budget > 0 )
+				{
+				now = current_time(true);
+
+				if ( now - start >= budget )
+					deferred = i;
+				}
+			}
+		}
+
+	if ( processed )
+		{
+		if ( budget <= 0 )
+			now = current_time(true);
+
+		double pause = now - start;
+		++process_stats.rounds;
+		process_stats.last_pause = pause;
+		process_stats.total_pause += pause;
+
+		if ( pause > process_stats.max_pause )
+			process_stats.max_pause = pause;
+		}
+
+	bool pending = false;
+
+	if ( deferred != msg_threads.end() )
+		{
+		// Give the threads after the one we stopped at their turn
+		// first in the next round, which follows as soon as possible.
+		msg_threads.splice(msg_threads.end(), msg_threads,
+		                   msg_threads.begin(), std::next(deferred));
+
+		for ( msg_thread_list::iterator i = msg_threads.begin(); i != msg_threads.end(); i++ )
+			{
+			if ( (*i)->HasOut() )
+				{
+				pending = true;
+				break;
+				}
+			}
+
+		if ( pending )
+			{
+			++process_stats.deferrals;
+			did_process = true;
 			}
 		}
 
@@ -154,7 +213,15 @@ void Manager::Process()
 		BasicThread* t = *i;
 
 		if ( t->Killed() )
+			{
+			// Don't lose output that we had to defer.
+			MsgThread* mt = dynamic_cast<MsgThread *>(t);
+
+			if ( pending && mt && mt->HasOut() )
+				continue;
+
 			to_delete.push_back(t);
+			}
 		}
 
 	for ( all_thread_list::iterator i = to_delete.begin(); i != to_delete.end(); i++ )
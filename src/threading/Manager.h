@@ -60,6 +60,25 @@ public:
 	 */
 	const msg_stats_list& GetMsgThreadStats();
 
+	/**
+	 * Statistics about the time the main loop spends processing
+	 * messages from threads.
+	 */
+	struct ProcessStats {
+		uint64_t rounds;	//! Iterations that processed messages.
+		uint64_t deferrals;	//! Iterations that left messages queued
+					//! because Threading::max_process_time
+					//! was reached.
+		double last_pause;	//! Time spent in the most recent one.
+		double max_pause;	//! Longest time spent in one iteration.
+		double total_pause;	//! Time spent overall.
+	};
+
+	/**
+	 * Returns statistics about message processing in the main loop.
+	 */
+	const ProcessStats& GetProcessStats() const	{ return process_stats; }
+
 	/**
 	 * Returns the number of currently active threads. This counts all
 	 * threads that are not yet joined, includingt any potentially in
@@ -132,6 +151,7 @@ private:
 	bool terminating;	// True if we are in Terminate().
 
 	msg_stats_list stats;
+	ProcessStats process_stats;
 };
 
 }
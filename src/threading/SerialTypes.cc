@@ -113,6 +113,35 @@ Value::~Value()
 		}
 	}
 
+Value** Value::NewVals(int num_fields)
+	{
+	Value** vals = new Value*[num_fields];
+
+	if ( num_fields == 0 )
+		return vals;
+
+	Value* block = new Value[num_fields];
+	block[0].block_start = true;
+
+	for ( int i = 0; i < num_fields; ++i )
+		vals[i] = &block[i];
+
+	return vals;
+	}
+
+void Value::DeleteVals(int num_fields, Value** vals)
+	{
+	if ( num_fields > 0 && vals[0]->block_start )
+		delete [] vals[0];
+	else
+		{
+		for ( int i = 0; i < num_fields; i++ )
+			delete vals[i];
+		}
+
+	delete [] vals;
+	}
+
 bool Value::IsCompatibleType(BroType* t, bool atomic_only)
 	{
 	if ( ! t )
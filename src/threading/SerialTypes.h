@@ -144,7 +144,8 @@ struct Value {
 	* that is not set.
 	 */
 	Value(TypeTag arg_type = TYPE_ERROR, bool arg_present = true)
-		: type(arg_type), subtype(TYPE_VOID), present(arg_present)	{}
+		: type(arg_type), subtype(TYPE_VOID), present(arg_present),
+		  block_start(false)	{}
 
 	/**
 	* Constructor.
@@ -157,7 +158,8 @@ struct Value {
 	* that is not set.
 	 */
 	Value(TypeTag arg_type, TypeTag arg_subtype, bool arg_present = true)
-		: type(arg_type), subtype(arg_subtype), present(arg_present)	{}
+		: type(arg_type), subtype(arg_subtype), present(arg_present),
+		  block_start(false)	{}
 
 	/**
 	 * Destructor.
@@ -189,9 +191,32 @@ struct Value {
 	 * method is thread-safe. */
 	static bool IsCompatibleType(BroType* t, bool atomic_only=false);
 
+	/**
+	 * Allocates an array of values, e.g. for the fields of a log record,
+	 * with all of the values in a single block.  The array must be
+	 * released with DeleteVals().
+	 *
+	 * @param num_fields The number of values.
+	 *
+	 * @return The array of default-constructed values.
+	 */
+	static Value** NewVals(int num_fields);
+
+	/**
+	 * Deletes an array of values along with the values, which may have
+	 * been allocated either individually or through NewVals().
+	 *
+	 * @param num_fields The number of values in the array.
+	 *
+	 * @param vals The array.
+	 */
+	static void DeleteVals(int num_fields, Value** vals);
+
 private:
 	friend class ::IPAddr;
 	Value(const Value& other)	{ } // Disabled.
+
+	bool block_start;	//! True for the first value allocated by NewVals().
 };
 
 }
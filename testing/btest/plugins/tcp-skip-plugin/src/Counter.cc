@@ -0,0 +1,66 @@
+
+#include "Counter.h"
+#include "counter.bif.h"
+
+#include <analyzer/protocol/tcp/TCP_Reassembler.h>
+
+using namespace plugin::Demo_Foo;
+
+Counter::Counter(Connection* conn)
+    : analyzer::tcp::TCP_ApplicationAnalyzer("Counter", conn)
+	{
+	for ( int i = 0; i < 2; ++i )
+		start[i] = delivered[i] = undelivered[i] = 0;
+	}
+
+void Counter::Init()
+	{
+	analyzer::tcp::TCP_ApplicationAnalyzer::Init();
+
+	start[0] = StreamSeq(false);
+	start[1] = StreamSeq(true);
+	}
+
+void Counter::Done()
+	{
+	analyzer::tcp::TCP_ApplicationAnalyzer::Done();
+
+	for ( int i = 0; i < 2; ++i )
+		{
+		bool orig = (i == 1);
+
+		ConnectionEventFast(counter_done, {
+			BuildConnVal(),
+			val_mgr->GetBool(orig),
+			val_mgr->GetCount(start[i]),
+			val_mgr->GetCount(StreamSeq(orig)),
+			val_mgr->GetCount(delivered[i]),
+			val_mgr->GetCount(undelivered[i]),
+		});
+		}
+	}
+
+void Counter::DeliverStream(int len, const u_char* data, bool orig)
+	{
+	analyzer::tcp::TCP_ApplicationAnalyzer::DeliverStream(len, data, orig);
+	delivered[orig] += len;
+	}
+
+void Counter::Undelivered(uint64_t seq, int len, bool orig)
+	{
+	analyzer::tcp::TCP_ApplicationAnalyzer::Undelivered(seq, len, orig);
+	undelivered[orig] += len;
+	}
+
+uint64_t Counter::StreamSeq(bool orig)
+	{
+	if ( ! TCP() )
+		return 0;
+
+	analyzer::tcp::TCP_Endpoint* endp = orig ? TCP()->Orig() : TCP()->Resp();
+
+	if ( ! endp->contents_processor )
+		return 0;
+
+	return endp->contents_processor->DataSeq();
+	}
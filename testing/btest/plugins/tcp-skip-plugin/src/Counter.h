@@ -0,0 +1,31 @@
+
+#pragma once
+
+#include "analyzer/protocol/tcp/TCP.h"
+
+namespace plugin {
+namespace Demo_Foo {
+
+// Counts the stream payload it gets, starting from wherever reassembly
+// was when it got added to the connection.
+class Counter : public analyzer::tcp::TCP_ApplicationAnalyzer {
+public:
+	Counter(Connection* conn);
+
+	void Init() override;
+	void Done() override;
+	void DeliverStream(int len, const u_char* data, bool orig) override;
+	void Undelivered(uint64_t seq, int len, bool orig) override;
+
+	static analyzer::Analyzer* Instantiate(Connection* conn)
+		{ return new Counter(conn); }
+
+protected:
+	uint64_t StreamSeq(bool orig);
+
+	uint64_t start[2];
+	uint64_t delivered[2];
+	uint64_t undelivered[2];
+};
+
+} }
@@ -0,0 +1,98 @@
+#! /usr/bin/env python
+#
+# A minimal DNS server for testing Zeek's own lookups against loopback.  It
+# answers PTR queries for 127.0.0.0/8 with "host<N>.example", A queries for
+# "ok.example" with 10.0.0.1, and everything else with NXDOMAIN.  Each
+# query it receives is appended to the file given with --log.
+
+import socket
+import struct
+
+PTR = 12
+A = 1
+
+
+def parse_question(msg):
+    labels = []
+    i = 12
+
+    while True:
+        n = ord(msg[i:i + 1])
+        i += 1
+
+        if n == 0:
+            break
+
+        labels.append(msg[i:i + n].decode("ascii"))
+        i += n
+
+    qtype, qclass = struct.unpack("!HH", msg[i:i + 4])
+    return ".".join(labels), qtype, msg[12:i + 4]
+
+
+def encode_name(name):
+    out = b""
+
+    for label in name.split("."):
+        out += struct.pack("!B", len(label)) + label.encode("ascii")
+
+    return out + b"\x00"
+
+
+def answer(name, qtype):
+    labels = name.lower().split(".")
+
+    if (qtype == PTR and len(labels) == 6 and labels[3] == "127" and
+            labels[4:] == ["in-addr", "arpa"]):
+        return encode_name("host%s.example" % labels[0])
+
+    if qtype == A and name.lower() == "ok.example":
+        return socket.inet_aton("10.0.0.1")
+
+    return None
+
+
+def respond(msg):
+    qid, = struct.unpack("!H", msg[:2])
+    name, qtype, question = parse_question(msg)
+    rdata = answer(name, qtype)
+
+    if rdata is None:
+        header = struct.pack("!HHHHHH", qid, 0x8183, 1, 0, 0, 0)
+        return name, qtype, header + question
+
+    header = struct.pack("!HHHHHH", qid, 0x8180, 1, 1, 0, 0)
+    rr = struct.pack("!HHHIH", 0xc00c, qtype, 1, 300, len(rdata)) + rdata
+    return name, qtype, header + question + rr
+
+
+if __name__ == "__main__":
+    from optparse import OptionParser
+    p = OptionParser()
+    p.add_option("-a", "--addr", type="string", default="127.0.0.1",
+                 help="listen on given address")
+    p.add_option("-p", "--port", type="int", default=53053,
+                 help="listen on given UDP port number")
+    p.add_option("-l", "--log", type="string", default="queries.log",
+                 help="file to record received queries in")
+    p.add_option("-m", "--max", type="int", default=-1,
+                 help="max number of queries to respond to, -1 means no max")
+    options, args = p.parse_args()
+
+    s = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    s.bind((options.addr, options.port))
+    served_count = 0
+
+    while served_count != options.max:
+        msg, peer = s.recvfrom(512)
+        served_count += 1
+
+        try:
+            name, qtype, reply = respond(msg)
+        except Exception:
+            continue
+
+        with open(options.log, "a") as f:
+            f.write("%s %d\n" % (name, qtype))
+
+        s.sendto(reply, peer)